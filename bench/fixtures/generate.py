@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Writes the synthetic Open-Meteo forecast responses replayed by `program replay`.
+
+The bodies follow the shape of the query built by formatWeatherQueryPath
+(current=is_day, hourly temperature/dew point/rain/cloud cover, daily
+sunrise/sunset/daylight duration, timezone=auto). Sunrise and sunset come from the NOAA solar
+equations, local times from the tz database, and the weather from a seeded
+generator, so rerunning this script reproduces the corpus byte for byte.
+Days without a sunrise or sunset (polar day and night) carry the day's
+00:00 for both events and a daylight duration of 86400 or 0 seconds.
+
+Usage: python3 bench/fixtures/generate.py [output-dir]
+"""
+
+import datetime
+import json
+import math
+import os
+import random
+import sys
+from zoneinfo import ZoneInfo
+
+UTC = datetime.timezone.utc
+
+
+def solar_hour_angle(day, latitude):
+    """Cosine of the sunrise hour angle and the equation of time in minutes; |cosine| > 1 if the sun stays up or down."""
+    n = day.timetuple().tm_yday
+    gamma = 2 * math.pi / 365 * (n - 1)
+    eqtime = 229.18 * (0.000075 + 0.001868 * math.cos(gamma) - 0.032077 * math.sin(gamma)
+                       - 0.014615 * math.cos(2 * gamma) - 0.040849 * math.sin(2 * gamma))
+    decl = (0.006918 - 0.399912 * math.cos(gamma) + 0.070257 * math.sin(gamma)
+            - 0.006758 * math.cos(2 * gamma) + 0.000907 * math.sin(2 * gamma)
+            - 0.002697 * math.cos(3 * gamma) + 0.00148 * math.sin(3 * gamma))
+    lat = math.radians(latitude)
+    cos_ha = (math.cos(math.radians(90.833)) / (math.cos(lat) * math.cos(decl))
+              - math.tan(lat) * math.tan(decl))
+    return cos_ha, eqtime
+
+
+def solar_event(day, latitude, longitude, rising):
+    """UTC time of sunrise or sunset on a date, or None if the sun does not cross the horizon."""
+    cos_ha, eqtime = solar_hour_angle(day, latitude)
+    if abs(cos_ha) > 1:
+        return None
+    ha = math.degrees(math.acos(cos_ha)) * (1 if rising else -1)
+    minutes = 720 - 4 * (longitude + ha) - eqtime
+    return datetime.datetime(day.year, day.month, day.day, tzinfo=UTC) + datetime.timedelta(minutes=minutes)
+
+
+def local(moment, zone):
+    return moment.astimezone(zone).strftime("%Y-%m-%dT%H:%M")
+
+
+def forecast(latitude, longitude, zone_name, now_utc, seed, hours=48, climate=(-5, 15), wet=0.3):
+    """One response as requested by the firmware: `hours` hourly values from the current hour."""
+    zone = ZoneInfo(zone_name)
+    rng = random.Random(seed)
+    now = now_utc.replace(tzinfo=UTC)
+    local_now = now.astimezone(zone)
+    offset = int(local_now.utcoffset().total_seconds())
+
+    first = now.replace(minute=0, second=0)
+    times, temperature, dew_point, rain, cloud = [], [], [], [], []
+    for i in range(hours):
+        moment = first + datetime.timedelta(hours=i)
+        times.append(local(moment, zone))
+        t = round(rng.uniform(*climate), 1)
+        temperature.append(t)
+        dew_point.append(round(t - rng.uniform(0.3, 8.0), 1))
+        rain.append(round(rng.choice([0.0, 0.1, 0.4, 1.2, 2.5]) if rng.random() < wet else 0.0, 1))
+        cloud.append(rng.randint(0, 100))
+
+    days = [local_now.date() + datetime.timedelta(days=i) for i in range(3)]
+    sunrise, sunset, daylight = [], [], []
+    for day in days:
+        midnight = day.strftime("%Y-%m-%dT00:00")
+        rise = solar_event(day, latitude, longitude, True)
+        set_ = solar_event(day, latitude, longitude, False)
+        sunrise.append(local(rise, zone) if rise else midnight)
+        sunset.append(local(set_, zone) if set_ else midnight)
+        if rise and set_:
+            daylight.append(round((set_ - rise).total_seconds(), 2))
+        else:
+            daylight.append(86400.0 if solar_hour_angle(day, latitude)[0] < -1 else 0.0)
+
+    return {
+        "latitude": latitude,
+        "longitude": longitude,
+        "generationtime_ms": 0.07,
+        "utc_offset_seconds": offset,
+        "timezone": zone_name,
+        "timezone_abbreviation": local_now.tzname(),
+        "elevation": 100.0,
+        "current_units": {"time": "iso8601", "interval": "seconds", "is_day": ""},
+        "current": {"time": local(now, zone), "interval": 900, "is_day": 0},
+        "hourly_units": {"time": "iso8601", "temperature_2m": "°C", "dew_point_2m": "°C", "rain": "mm",
+                         "cloud_cover": "%"},
+        "hourly": {"time": times, "temperature_2m": temperature, "dew_point_2m": dew_point, "rain": rain,
+                   "cloud_cover": cloud},
+        "daily_units": {"time": "iso8601", "sunrise": "iso8601", "sunset": "iso8601", "daylight_duration": "s"},
+        "daily": {"time": [d.isoformat() for d in days], "sunrise": sunrise, "sunset": sunset,
+                  "daylight_duration": daylight},
+    }
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    d = datetime.datetime
+    valid = {
+        "freiburg_evening": forecast(47.9827, 7.713736, "Europe/Berlin", d(2024, 3, 15, 20, 15), 1),
+        "freiburg_afternoon": forecast(47.9827, 7.713736, "Europe/Berlin", d(2024, 3, 15, 13, 0), 2, hours=17),
+        "freiburg_first_72h": forecast(47.9827, 7.713736, "Europe/Berlin", d(2024, 3, 15, 20, 15), 3, hours=72),
+        "singapore_equator": forecast(1.3521, 103.8198, "Asia/Singapore", d(2024, 6, 10, 12, 0), 4,
+                                      climate=(24, 32), wet=0.6),
+        "sydney_southern": forecast(-33.8688, 151.2093, "Australia/Sydney", d(2024, 1, 20, 9, 30), 5,
+                                    climate=(18, 28)),
+        "quito_altitude": forecast(-0.1807, -78.4678, "America/Guayaquil", d(2024, 9, 1, 23, 45), 6,
+                                   climate=(8, 20), wet=0.5),
+        "tromso_polar_night": forecast(69.6492, 18.9553, "Europe/Oslo", d(2024, 12, 20, 15, 0), 7,
+                                       climate=(-12, 0)),
+        "tromso_polar_night_begins": forecast(69.6492, 18.9553, "Europe/Oslo", d(2024, 11, 26, 13, 0), 13,
+                                              hours=72, climate=(-10, 2)),
+        "longyearbyen_polar_day": forecast(78.2232, 15.6267, "Arctic/Longyearbyen", d(2024, 6, 21, 10, 0), 8,
+                                           climate=(0, 8)),
+        "reykjavik_midsummer": forecast(64.1466, -21.9426, "Atlantic/Reykjavik", d(2024, 6, 21, 21, 0), 9,
+                                        climate=(6, 14)),
+        "berlin_dst_spring": forecast(52.52, 13.405, "Europe/Berlin", d(2024, 3, 30, 17, 0), 10),
+        "newyork_dst_autumn": forecast(40.7128, -74.006, "America/New_York", d(2024, 11, 2, 20, 0), 11,
+                                       climate=(4, 16)),
+        "dateline_kiribati": forecast(1.87, -157.36, "Pacific/Kiritimati", d(2024, 5, 5, 6, 0), 12,
+                                      climate=(25, 30)),
+    }
+    for name, body in valid.items():
+        with open(os.path.join(out, name + ".json"), "w", encoding="utf-8") as f:
+            json.dump(body, f, ensure_ascii=False, separators=(",", ":"))
+
+    # Bodies the parser must reject
+    reference = json.dumps(valid["freiburg_evening"], ensure_ascii=False, separators=(",", ":"))
+    broken = {
+        "bad_truncated": reference[: len(reference) // 2],
+        "bad_no_daily": json.dumps({k: v for k, v in valid["freiburg_evening"].items() if k != "daily"},
+                                   ensure_ascii=False, separators=(",", ":")),
+        "bad_unbalanced": reference.replace("]}", "}", 1),
+        "bad_html_error": "<html><body><h1>502 Bad Gateway</h1></body></html>\n",
+        "bad_empty": "",
+        "bad_top_level_scalar": "1,",
+        "bad_top_level_string": "\"x\"]",
+    }
+    for name, body in broken.items():
+        with open(os.path.join(out, name + ".json"), "w", encoding="utf-8") as f:
+            f.write(body)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,37 @@
+#ifndef BACKOFF_H
+#define BACKOFF_H
+
+#include <Arduino.h>
+
+// Retry schedule with exponential backoff: waits initial, 2x, 4x, ... up to maximum milliseconds.
+class Backoff
+{
+public:
+  Backoff(unsigned long initialMs, unsigned long maximumMs)
+      : initialMs(initialMs), maximumMs(maximumMs), delayMs(initialMs), waitMs(0), lastAttempt(0)
+  {
+  }
+
+  // Back to the initial delay, e.g. after a success.
+  void reset() { delayMs = initialMs; }
+
+  // Records a failed attempt at now; the next one is due after the current delay, which then doubles.
+  void schedule(unsigned long now)
+  {
+    lastAttempt = now;
+    waitMs = delayMs;
+    delayMs = min(delayMs * 2, maximumMs);
+  }
+
+  bool isDue(unsigned long now) const { return now - lastAttempt >= waitMs; }
+  unsigned long currentWait() const { return waitMs; }
+
+private:
+  unsigned long initialMs;
+  unsigned long maximumMs;
+  unsigned long delayMs;
+  unsigned long waitMs;
+  unsigned long lastAttempt;
+};
+
+#endif // BACKOFF_H
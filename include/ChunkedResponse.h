@@ -0,0 +1,36 @@
+#ifndef CHUNKEDRESPONSE_H
+#define CHUNKEDRESPONSE_H
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+
+/**
+ * Print that streams an HTTP response body with chunked transfer. Output is
+ * collected in a small buffer and sent as one chunk whenever the buffer fills,
+ * so a long body can be printed piece by piece without building it in RAM.
+ */
+class ChunkedResponse : public Print
+{
+public:
+  explicit ChunkedResponse(ESP8266WebServer &server);
+
+  // Sends the status line and headers; the body follows through the Print interface.
+  void begin(int code, const char *contentType);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t size) override;
+  using Print::write;
+
+  // Sends what is still buffered and the terminating chunk.
+  void end();
+
+private:
+  static const size_t BUFFER_SIZE = 256;
+
+  void sendBuffer();
+
+  ESP8266WebServer &server;
+  char buffer[BUFFER_SIZE];
+  size_t length;
+};
+
+#endif // CHUNKEDRESPONSE_H
@@ -0,0 +1,41 @@
+#ifndef LEDFRAMEBUFFER_H
+#define LEDFRAMEBUFFER_H
+
+#include <Arduino.h>
+#include <LedControl.h>
+#include "Sprites.h"
+
+/**
+ * In-RAM image of a chain of four 8x8 MAX7219 matrices (32 columns x 8 rows).
+ * Drawing only touches memory; flush() sends each row of each device that
+ * changed since the previous flush with a single setRow transfer.
+ *
+ * Each row is a 32-bit word with column 0 in the most significant bit, so
+ * byte 3 (the top byte) belongs to device 0 and byte 0 to device 3.
+ */
+class LedFramebuffer
+{
+public:
+  static const uint8_t ROWS = 8;
+  static const uint8_t COLUMNS = 32;
+  static const uint8_t DEVICES = COLUMNS / 8;
+
+  explicit LedFramebuffer(LedControl &lc);
+
+  void clear();
+  void setPixel(int row, int col);
+
+  // OR a full-panel sprite (SPRITE_ROWS words in PROGMEM) into the buffer.
+  void blit(const uint32_t *sprite);
+  void flush();
+
+  // Forget what the panel shows so the next flush rewrites every row.
+  void invalidate();
+
+private:
+  LedControl &lc;
+  uint32_t rows[ROWS];
+  uint32_t shownRows[ROWS];
+};
+
+#endif // LEDFRAMEBUFFER_H
@@ -0,0 +1,48 @@
+#ifndef POWERMANAGER_H
+#define POWERMANAGER_H
+
+#include <Arduino.h>
+#include "SleepPlanner.h"
+
+enum class PowerMode : uint8_t
+{
+  Awake, // CPU and radio always on, as before
+  Modem, // The radio sleeps between beacons; loop() waits in delay() between events
+  Light  // As Modem, and the SDK also stops the CPU clock while loop() waits
+};
+
+/**
+ * Lets the device sleep between the events in the timer wheel instead of
+ * spinning through loop(). Waiting is done in delay(), which is where the
+ * SDK enters modem or light sleep, in slices of at most MAX_SLEEP_MS. While
+ * asleep the radio only wakes for every LISTEN_INTERVAL-th beacon (about
+ * 102 ms apart), the access point buffering frames meanwhile, so a request is
+ * answered after at most about MAX_SLEEP_MS + LISTEN_INTERVAL * 102 ms.
+ */
+class PowerManager
+{
+public:
+  explicit PowerManager(PowerMode mode);
+
+  // Sets the Wi-Fi sleep type; call before the station associates, the listen interval is fixed then.
+  void begin();
+
+  // A request was answered; stay fully awake for a moment in case more follow.
+  void noteActivity() { planner.noteActivity(millis()); }
+
+  // Sleeps until the next event is due or the next slice ends; call at the end of an idle loop().
+  void idle(unsigned long timeUntilNext);
+
+  // Percent of the time since the previous call spent idle in delay(), where the SDK may or may not have slept.
+  uint8_t takeIdlePercent() { return planner.takeIdlePercent(millis()); }
+
+private:
+  static const unsigned long MAX_SLEEP_MS = 100;
+  static const unsigned long AWAKE_AFTER_REQUEST_MS = 250;
+  static const uint8_t LISTEN_INTERVAL = 3;
+
+  PowerMode mode;
+  SleepPlanner planner;
+};
+
+#endif // POWERMANAGER_H
@@ -0,0 +1,29 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <Arduino.h>
+#include "SharedStructs.h"
+
+// A full-panel bitmap: one 32-bit word per row, column 0 in the most significant bit.
+const uint8_t SPRITE_ROWS = 8;
+typedef uint32_t Sprite[SPRITE_ROWS];
+
+// Builds one sprite row from a 32-character picture: '#' is lit, anything else is dark.
+constexpr uint32_t spriteRow(const char (&picture)[33])
+{
+  uint32_t bits = 0;
+  for (uint8_t col = 0; col < 32; col++)
+  {
+    bits = (bits << 1) | (picture[col] == '#' ? 1 : 0);
+  }
+  return bits;
+}
+
+extern const Sprite SPRITE_SUN_AND_EARTH PROGMEM;
+extern const Sprite SPRITE_STARS PROGMEM;
+extern const Sprite SPRITE_CLOUDS PROGMEM;
+
+// Sprite of a single body, or nullptr for Undefined.
+const uint32_t *planetSprite(CelestialObject object);
+
+#endif // SPRITES_H
@@ -0,0 +1,13 @@
+#ifndef STARGAZINGJSON_H
+#define STARGAZINGJSON_H
+
+#include <Arduino.h>
+#include "StargazingInfo.h"
+
+// Large enough for the weather block and all eight bodies with worst-case number widths.
+const size_t STARGAZING_JSON_SIZE = 1536;
+
+// Renders info as JSON into buffer; returns the length, or 0 if it did not fit.
+size_t serializeStargazingInfo(const StargazingInfo &info, char *buffer, size_t size);
+
+#endif // STARGAZINGJSON_H
@@ -0,0 +1,16 @@
+#ifndef STARGAZINGSTORE_H
+#define STARGAZINGSTORE_H
+
+#include "StargazingRecord.h"
+
+// Keeps the last StargazingSnapshot in LittleFS so a reboot can show it right away.
+
+// Mounts the file system, formatting it on first use.
+bool beginStargazingStore();
+
+bool loadStargazingSnapshot(StargazingSnapshot &snapshot);
+
+// Writes the snapshot unless the stored record is already identical, sparing the flash.
+bool saveStargazingSnapshot(const StargazingSnapshot &snapshot);
+
+#endif // STARGAZINGSTORE_H
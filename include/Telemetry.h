@@ -0,0 +1,65 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+// Parts of the firmware whose heap use is sampled separately.
+enum class Phase : uint8_t
+{
+  Fetch,  // One step of the stargazing fetch
+  Http,   // A web request handler
+  Render, // Drawing and flushing the LED panel
+};
+const uint8_t PHASE_COUNT = 3;
+
+// Running current/min/max of one sampled value.
+struct Gauge
+{
+  uint32_t current;
+  uint32_t min;
+  uint32_t max;
+
+  void update(uint32_t value);
+};
+
+// Heap walks per phase are at most this often; free heap is sampled every time.
+const unsigned long HEAP_WALK_INTERVAL_MS = 1000;
+
+struct PhaseMemory
+{
+  uint32_t samples;
+  Gauge freeHeap;      // Bytes
+  Gauge maxFreeBlock;  // Bytes; the largest allocation that can still succeed; from heap walks only
+  Gauge fragmentation; // Percent, as reported by the heap allocator; from heap walks only
+  unsigned long lastWalk;
+};
+
+// Samples the heap now and attributes the values to phase.
+void sampleMemory(Phase phase);
+
+const PhaseMemory &phaseMemory(Phase phase);
+
+// Samples the heap when a phase ends, which runs on every loop() pass while fetching.
+class PhaseScope
+{
+public:
+  explicit PhaseScope(Phase phase) : phase(phase) {}
+  ~PhaseScope();
+
+  PhaseScope(const PhaseScope &) = delete;
+  PhaseScope &operator=(const PhaseScope &) = delete;
+
+private:
+  Phase phase;
+};
+
+// Adds time loop() spent idle in delay() between events; the SDK may sleep then, which is not measured.
+void recordIdle(unsigned long ms);
+
+// Writes all telemetry in Prometheus text exposition format.
+void printMetrics(Print &out);
+
+// Writes a one-line memory summary, e.g. for the periodic Serial report.
+void printMemorySummary(Print &out);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,20 @@
+#ifndef WEBPAGE_H
+#define WEBPAGE_H
+
+#include <Arduino.h>
+
+// Static parts of the configuration page, kept in flash. The page is sent as
+// PAGE_HEAD, latitude, PAGE_LONGITUDE, longitude, PAGE_LEFT, left bound,
+// PAGE_RIGHT, right bound, PAGE_HORIZON, horizon profile, PAGE_TAIL; the values
+// go into the input fields.
+extern const char PAGE_HEAD[] PROGMEM;
+extern const char PAGE_LONGITUDE[] PROGMEM;
+extern const char PAGE_LEFT[] PROGMEM;
+extern const char PAGE_RIGHT[] PROGMEM;
+extern const char PAGE_HORIZON[] PROGMEM;
+extern const char PAGE_TAIL[] PROGMEM;
+
+// Bump whenever the static parts change, so cached pages are not revalidated against the old markup.
+const uint8_t PAGE_VERSION = 2;
+
+#endif // WEBPAGE_H
@@ -0,0 +1,46 @@
+#ifndef WIFICONNECTION_H
+#define WIFICONNECTION_H
+
+#include <Arduino.h>
+#include "Backoff.h"
+
+enum class WifiState : uint8_t
+{
+  Idle,
+  Connecting, // Association in progress
+  Connected,
+  Waiting     // Backing off after a failed attempt
+};
+
+/**
+ * Station-mode Wi-Fi association driven from loop(): nothing here waits.
+ * A failed or timed-out attempt is retried with exponential backoff, and a
+ * lost connection starts a new attempt right away.
+ */
+class WifiConnection
+{
+public:
+  WifiConnection(const char *ssid, const char *password);
+
+  void begin();
+
+  // Advances the connection; returns true when it has just come up.
+  bool update();
+
+  bool isConnected() const { return state == WifiState::Connected; }
+  WifiState getState() const { return state; }
+
+private:
+  static const unsigned long ATTEMPT_TIMEOUT_MS = 15000;
+
+  void startAttempt();
+  void failAttempt(const char *reason);
+
+  const char *ssid;
+  const char *password;
+  WifiState state;
+  unsigned long attemptStart;
+  Backoff backoff;
+};
+
+#endif // WIFICONNECTION_H
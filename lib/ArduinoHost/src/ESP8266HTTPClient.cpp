@@ -0,0 +1,146 @@
+#include "ESP8266HTTPClient.h"
+#include <stdio.h>
+#include <strings.h>
+
+bool HTTPClient::begin(WiFiClient &wifiClient, const String &url)
+{
+    const char *rest = url.c_str();
+    if (strncmp(rest, "http://", 7) != 0)
+        return false;
+    rest += 7;
+
+    const char *slash = strchr(rest, '/');
+    String authority = slash ? url.substring(rest - url.c_str(), slash - url.c_str()) : String(rest);
+    path = slash ? String(slash) : String("/");
+
+    int colon = authority.indexOf(':');
+    if (colon >= 0)
+    {
+        host = authority.substring(0, colon);
+        port = static_cast<uint16_t>(authority.substring(colon + 1).toInt());
+    }
+    else
+    {
+        host = authority;
+        port = 80;
+    }
+
+    client = &wifiClient;
+    contentLength = -1;
+    chunked = false;
+    return true;
+}
+
+void HTTPClient::end()
+{
+    if (client)
+        client->stop();
+}
+
+bool HTTPClient::readLine(char *line, size_t size)
+{
+    size_t length = 0;
+    for (;;)
+    {
+        char c;
+        if (client->readBytes(&c, 1) != 1)
+            return false;
+        if (c == '\n')
+            break;
+        if (c != '\r' && length + 1 < size)
+            line[length++] = c;
+    }
+    line[length] = '\0';
+    return true;
+}
+
+int HTTPClient::GET()
+{
+    if (!client)
+        return HTTPC_ERROR_NOT_CONNECTED;
+
+    client->setTimeout(timeout);
+    if (!client->connect(host.c_str(), port))
+        return HTTPC_ERROR_CONNECTION_FAILED;
+
+    String request = String("GET ") + path + (http10 ? " HTTP/1.0\r\n" : " HTTP/1.1\r\n") +
+                     "Host: " + host + "\r\n" +
+                     "User-Agent: ESP8266HTTPClient\r\n" +
+                     "Connection: close\r\n\r\n";
+    if (client->write(request.c_str(), request.length()) != request.length())
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+
+    char line[256];
+    if (!readLine(line, sizeof(line)))
+        return HTTPC_ERROR_READ_TIMEOUT;
+
+    int code = 0;
+    if (sscanf(line, "HTTP/%*d.%*d %d", &code) != 1)
+        return HTTPC_ERROR_NO_HTTP_SERVER;
+
+    while (readLine(line, sizeof(line)) && line[0] != '\0')
+    {
+        if (strncasecmp(line, "Content-Length:", 15) == 0)
+            contentLength = atoi(line + 15);
+        else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0)
+            chunked = strstr(line + 18, "chunked") != nullptr;
+    }
+
+    return code;
+}
+
+String HTTPClient::getString()
+{
+    String payload;
+    if (!client)
+        return payload;
+
+    if (!chunked)
+    {
+        if (contentLength > 0)
+            payload.reserve(contentLength);
+        return payload + client->readString();
+    }
+
+    char line[32];
+    char chunk[256];
+    while (readLine(line, sizeof(line)))
+    {
+        long remaining = strtol(line, nullptr, 16);
+        if (remaining <= 0)
+            break;
+        while (remaining > 0)
+        {
+            size_t n = client->readBytes(chunk, std::min<long>(remaining, sizeof(chunk)));
+            if (n == 0)
+                return payload;
+            payload.concat(chunk, n);
+            remaining -= n;
+        }
+        readLine(line, sizeof(line));
+    }
+    return payload;
+}
+
+String HTTPClient::errorToString(int error)
+{
+    switch (error)
+    {
+    case HTTPC_ERROR_CONNECTION_FAILED:
+        return F("connection failed");
+    case HTTPC_ERROR_SEND_HEADER_FAILED:
+        return F("send header failed");
+    case HTTPC_ERROR_NOT_CONNECTED:
+        return F("not connected");
+    case HTTPC_ERROR_CONNECTION_LOST:
+        return F("connection lost");
+    case HTTPC_ERROR_NO_HTTP_SERVER:
+        return F("no HTTP server");
+    case HTTPC_ERROR_ENCODING:
+        return F("Transfer-Encoding not supported");
+    case HTTPC_ERROR_READ_TIMEOUT:
+        return F("read Timeout");
+    default:
+        return String();
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef ARDUINO_HOST_ESP8266HTTPCLIENT_H
+#define ARDUINO_HOST_ESP8266HTTPCLIENT_H
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_FAILED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+enum t_http_codes
+{
+    HTTP_CODE_OK = 200,
+    HTTP_CODE_NOT_MODIFIED = 304,
+    HTTP_CODE_BAD_REQUEST = 400,
+    HTTP_CODE_NOT_FOUND = 404,
+    HTTP_CODE_INTERNAL_SERVER_ERROR = 500
+};
+
+// Plain-HTTP subset of the ESP8266 HTTPClient, enough for the Open-Meteo query.
+class HTTPClient
+{
+public:
+    bool begin(WiFiClient &client, const String &url);
+    void end();
+
+    void useHTTP10(bool usehttp10 = true) { http10 = usehttp10; }
+    void setTimeout(uint16_t timeoutMs) { timeout = timeoutMs; }
+
+    int GET();
+    int getSize() const { return contentLength; }
+    WiFiClient &getStream() { return *client; }
+    String getString();
+
+    static String errorToString(int error);
+
+private:
+    bool readLine(char *line, size_t size);
+
+    WiFiClient *client = nullptr;
+    String host;
+    String path;
+    uint16_t port = 80;
+    uint16_t timeout = 5000;
+    bool http10 = false;
+    bool chunked = false;
+    int contentLength = -1;
+};
+
+#endif // ARDUINO_HOST_ESP8266HTTPCLIENT_H
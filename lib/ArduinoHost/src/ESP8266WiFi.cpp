@@ -0,0 +1,22 @@
+#include "ESP8266WiFi.h"
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+ESP8266WiFiClass WiFi;
+
+int ESP8266WiFiClass::hostByName(const char *host, IPAddress &result, uint32_t)
+{
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *results = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &results) != 0)
+        return 0;
+
+    const uint8_t *address =
+        reinterpret_cast<const uint8_t *>(&reinterpret_cast<const sockaddr_in *>(results->ai_addr)->sin_addr.s_addr);
+    result = IPAddress(address[0], address[1], address[2], address[3]);
+    freeaddrinfo(results);
+    return 1;
+}
@@ -0,0 +1,19 @@
+#ifndef ARDUINO_HOST_ESP8266WIFI_H
+#define ARDUINO_HOST_ESP8266WIFI_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+
+// The host is always connected; only name resolution is provided.
+class ESP8266WiFiClass
+{
+public:
+    // Resolves host to an IPv4 address; returns 1 on success, 0 otherwise. The
+    // host resolver keeps its own timeouts, so timeoutMs is not enforced here.
+    int hostByName(const char *host, IPAddress &result, uint32_t timeoutMs);
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif // ARDUINO_HOST_ESP8266WIFI_H
@@ -0,0 +1,20 @@
+#ifndef ARDUINO_HOST_IPADDRESS_H
+#define ARDUINO_HOST_IPADDRESS_H
+
+#include <stdint.h>
+
+// IPv4 address with the parts of the ESP8266 IPAddress surface the library uses.
+class IPAddress
+{
+public:
+    IPAddress() : bytes{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+
+    uint8_t operator[](int index) const { return bytes[index]; }
+    bool isSet() const { return bytes[0] != 0 || bytes[1] != 0 || bytes[2] != 0 || bytes[3] != 0; }
+
+private:
+    uint8_t bytes[4];
+};
+
+#endif // ARDUINO_HOST_IPADDRESS_H
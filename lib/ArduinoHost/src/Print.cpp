@@ -0,0 +1,85 @@
+#include "Print.h"
+#include <stdio.h>
+#include <string.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        if (!write(*buffer++))
+            break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::write(const char *str)
+{
+    return str ? write(reinterpret_cast<const uint8_t *>(str), strlen(str)) : 0;
+}
+
+size_t Print::write(const char *buffer, size_t size)
+{
+    return write(reinterpret_cast<const uint8_t *>(buffer), size);
+}
+
+size_t Print::print(const __FlashStringHelper *str)
+{
+    return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(const String &str)
+{
+    return write(str.c_str(), str.length());
+}
+
+size_t Print::print(const char *str)
+{
+    return write(str);
+}
+
+size_t Print::print(char c)
+{
+    return write(static_cast<uint8_t>(c));
+}
+
+size_t Print::print(int value, int base)
+{
+    return print(static_cast<long>(value), base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return print(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(long value, int base)
+{
+    return print(String(value, static_cast<unsigned char>(base)));
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    return print(String(value, static_cast<unsigned char>(base)));
+}
+
+size_t Print::print(long long value, int base)
+{
+    return print(static_cast<long>(value), base);
+}
+
+size_t Print::print(unsigned long long value, int base)
+{
+    return print(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(double value, int digits)
+{
+    return print(String(value, static_cast<unsigned char>(digits)));
+}
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
@@ -0,0 +1,37 @@
+#include "Arduino.h"
+
+int Stream::timedRead()
+{
+    unsigned long start = millis();
+    do
+    {
+        int c = read();
+        if (c >= 0)
+            return c;
+        yield();
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t count = 0;
+    while (count < length)
+    {
+        int c = timedRead();
+        if (c < 0)
+            break;
+        buffer[count++] = static_cast<char>(c);
+    }
+    return count;
+}
+
+String Stream::readString()
+{
+    String result;
+    char chunk[256];
+    size_t n;
+    while ((n = readBytes(chunk, sizeof(chunk))) > 0)
+        result.concat(chunk, n);
+    return result;
+}
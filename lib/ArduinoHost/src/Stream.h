@@ -0,0 +1,30 @@
+#ifndef ARDUINO_HOST_STREAM_H
+#define ARDUINO_HOST_STREAM_H
+
+#include "Print.h"
+
+// Subset of the Arduino Stream interface, as consumed by ArduinoJson.
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeoutMs) { timeout = timeoutMs; }
+    unsigned long getTimeout() const { return timeout; }
+
+    virtual size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length)
+    {
+        return readBytes(reinterpret_cast<char *>(buffer), length);
+    }
+    String readString();
+
+protected:
+    int timedRead();
+
+    unsigned long timeout = 1000;
+};
+
+#endif // ARDUINO_HOST_STREAM_H
@@ -0,0 +1,180 @@
+#include "WString.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static std::string formatInteger(unsigned long long magnitude, bool negative, unsigned char base)
+{
+    if (base < 2 || base > 36)
+        base = 10;
+
+    char digits[66];
+    char *cursor = digits + sizeof(digits) - 1;
+    *cursor = '\0';
+    do
+    {
+        unsigned int digit = static_cast<unsigned int>(magnitude % base);
+        *--cursor = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        magnitude /= base;
+    } while (magnitude != 0);
+
+    if (negative)
+        *--cursor = '-';
+    return std::string(cursor);
+}
+
+static std::string formatSigned(long long value, unsigned char base)
+{
+    bool negative = value < 0 && base == 10;
+    unsigned long long magnitude = negative ? 0ULL - static_cast<unsigned long long>(value)
+                                            : static_cast<unsigned long long>(value);
+    if (value < 0 && base != 10)
+        magnitude = static_cast<unsigned long>(value);
+    return formatInteger(magnitude, negative, base);
+}
+
+static std::string formatFloat(double value, unsigned char decimalPlaces)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    return std::string(buf);
+}
+
+String::String(int value, unsigned char base) : buffer(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : buffer(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base) : buffer(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : buffer(formatInteger(value, false, base)) {}
+String::String(float value, unsigned char decimalPlaces) : buffer(formatFloat(value, decimalPlaces)) {}
+String::String(double value, unsigned char decimalPlaces) : buffer(formatFloat(value, decimalPlaces)) {}
+
+bool String::reserve(unsigned int size)
+{
+    buffer.reserve(size);
+    return true;
+}
+
+bool String::concat(const String &str)
+{
+    buffer += str.buffer;
+    return true;
+}
+
+bool String::concat(const char *cstr)
+{
+    if (!cstr)
+        return false;
+    buffer += cstr;
+    return true;
+}
+
+bool String::concat(const char *cstr, unsigned int length)
+{
+    if (!cstr)
+        return false;
+    buffer.append(cstr, length);
+    return true;
+}
+
+bool String::concat(char c)
+{
+    buffer += c;
+    return true;
+}
+
+String &String::operator+=(const String &rhs)
+{
+    concat(rhs);
+    return *this;
+}
+
+String &String::operator+=(const char *rhs)
+{
+    concat(rhs);
+    return *this;
+}
+
+String &String::operator+=(char rhs)
+{
+    concat(rhs);
+    return *this;
+}
+
+char String::operator[](unsigned int index) const
+{
+    return index < buffer.length() ? buffer[index] : '\0';
+}
+
+char &String::operator[](unsigned int index)
+{
+    static char dummy;
+    if (index >= buffer.length())
+    {
+        dummy = '\0';
+        return dummy;
+    }
+    return buffer[index];
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const
+{
+    size_t found = buffer.find(c, fromIndex);
+    return found == std::string::npos ? -1 : static_cast<int>(found);
+}
+
+String String::substring(unsigned int beginIndex) const
+{
+    return substring(beginIndex, length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+    if (beginIndex > endIndex)
+        std::swap(beginIndex, endIndex);
+    if (beginIndex >= buffer.length())
+        return String();
+    if (endIndex > buffer.length())
+        endIndex = buffer.length();
+    return String(buffer.substr(beginIndex, endIndex - beginIndex).c_str());
+}
+
+long String::toInt() const
+{
+    return atol(buffer.c_str());
+}
+
+float String::toFloat() const
+{
+    return static_cast<float>(toDouble());
+}
+
+double String::toDouble() const
+{
+    return atof(buffer.c_str());
+}
+
+String operator+(const String &lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String &lhs, const char *rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String &lhs, char rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
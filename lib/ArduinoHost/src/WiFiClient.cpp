@@ -0,0 +1,176 @@
+#include "WiFiClient.h"
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClient::~WiFiClient()
+{
+    stop();
+}
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+    stop();
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *results = nullptr;
+    if (getaddrinfo(host, service, &hints, &results) != 0)
+        return 0;
+
+    for (struct addrinfo *ai = results; ai != nullptr; ai = ai->ai_next)
+    {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0)
+            continue;
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+            break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(results);
+
+    peerClosed = false;
+    rxStart = rxEnd = 0;
+    return fd >= 0 ? 1 : 0;
+}
+
+int WiFiClient::connect(const IPAddress &address, uint16_t port)
+{
+    stop();
+
+    struct sockaddr_in peer = {};
+    peer.sin_family = AF_INET;
+    peer.sin_port = htons(port);
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(&peer.sin_addr.s_addr);
+    for (int i = 0; i < 4; ++i)
+        bytes[i] = address[i];
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<struct sockaddr *>(&peer), sizeof(peer)) != 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+
+    peerClosed = false;
+    rxStart = rxEnd = 0;
+    return fd >= 0 ? 1 : 0;
+}
+
+bool WiFiClient::connected()
+{
+    if (fd < 0)
+        return false;
+    if (rxStart < rxEnd)
+        return true;
+    fill(0);
+    return rxStart < rxEnd || !peerClosed;
+}
+
+void WiFiClient::stop()
+{
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+    peerClosed = true;
+    rxStart = rxEnd = 0;
+}
+
+size_t WiFiClient::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+    size_t sent = 0;
+    while (fd >= 0 && sent < size)
+    {
+        ssize_t n = ::send(fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        sent += static_cast<size_t>(n);
+    }
+    return sent;
+}
+
+// Pulls more bytes from the socket into the receive buffer, waiting at most waitMs.
+bool WiFiClient::fill(int waitMs)
+{
+    if (rxStart < rxEnd)
+        return true;
+    if (fd < 0 || peerClosed)
+        return false;
+
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (poll(&pfd, 1, waitMs) <= 0)
+        return false;
+
+    ssize_t n = ::recv(fd, rxBuffer, sizeof(rxBuffer), 0);
+    if (n <= 0)
+    {
+        peerClosed = true;
+        return false;
+    }
+    rxStart = 0;
+    rxEnd = static_cast<size_t>(n);
+    return true;
+}
+
+int WiFiClient::available()
+{
+    fill(0);
+    return static_cast<int>(rxEnd - rxStart);
+}
+
+int WiFiClient::read()
+{
+    return fill(0) ? rxBuffer[rxStart++] : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size)
+{
+    if (!fill(0))
+        return -1;
+    size_t n = std::min(size, rxEnd - rxStart);
+    memcpy(buffer, rxBuffer + rxStart, n);
+    rxStart += n;
+    return static_cast<int>(n);
+}
+
+int WiFiClient::peek()
+{
+    return fill(0) ? rxBuffer[rxStart] : -1;
+}
+
+size_t WiFiClient::readBytes(char *buffer, size_t length)
+{
+    size_t count = 0;
+    unsigned long start = millis();
+    while (count < length)
+    {
+        if (!fill(10))
+        {
+            if (peerClosed || fd < 0 || millis() - start >= timeout)
+                break;
+            continue;
+        }
+        size_t n = std::min(length - count, rxEnd - rxStart);
+        memcpy(buffer + count, rxBuffer + rxStart, n);
+        rxStart += n;
+        count += n;
+        start = millis();
+    }
+    return count;
+}
@@ -0,0 +1,42 @@
+#ifndef ARDUINO_HOST_WIFICLIENT_H
+#define ARDUINO_HOST_WIFICLIENT_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+// Plain TCP client over POSIX sockets with the ESP8266 WiFiClient surface.
+class WiFiClient : public Stream
+{
+public:
+    WiFiClient() {}
+    ~WiFiClient() override;
+    WiFiClient(const WiFiClient &) = delete;
+    WiFiClient &operator=(const WiFiClient &) = delete;
+
+    int connect(const char *host, uint16_t port);
+    int connect(const IPAddress &address, uint16_t port);
+    bool connected();
+    void stop();
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size);
+    int peek() override;
+    size_t readBytes(char *buffer, size_t length) override;
+    using Stream::readBytes;
+
+private:
+    bool fill(int waitMs);
+
+    int fd = -1;
+    bool peerClosed = false;
+    uint8_t rxBuffer[512];
+    size_t rxStart = 0;
+    size_t rxEnd = 0;
+};
+
+#endif // ARDUINO_HOST_WIFICLIENT_H
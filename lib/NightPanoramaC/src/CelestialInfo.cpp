@@ -1,27 +1,23 @@
-#include <SiderealPlanets.h>
-#include <random>
 #include "CelestialInfo.h"
+#include "Latency.h"
 #include "Utils.h"
 
-// Instance to perform astronomical calculations.
-SiderealPlanets astro;
-
-// Random number generator for simulation purposes.
-std::random_device rd;
-std::mt19937 gen(rd());
-
-// Array of celestial body names.
-const char *names[MAX_CELESTIAL_BODIES] = {"Moon", "Mercury", "Venus", "Mars", "Jupiter", "Saturn", "Uranus", "Neptune"};
+CelestialEngine::CelestialEngine()
+    : simulationState(0), horizon{}, maskFov{0, 360}, cacheEntries{}, cacheStats{0, 0},
+      cachePrecision(CELESTIAL_CACHE_DEFAULT_PRECISION), cacheClock(0)
+{
+}
 
-// Initialize astronomical calculations with a given geographic location.
-void initSiderealPlanets(const GeoLocation &location)
+CelestialEngine &defaultCelestialEngine()
 {
-    astro.setLatLong(location.latitude, location.longitude);
+    static CelestialEngine engine;
+    return engine;
 }
 
 // Compute rise and set times for a celestial object.
-RiseAndSet getRiseAndSetTimes(const CelestialObject &object, time_t sunset)
+RiseAndSet getRiseAndSetTimes(CelestialEngine &engine, const CelestialObject &object, time_t sunset)
 {
+    SiderealPlanets &astro = engine.calculator();
     RiseAndSet times = {0, 0};
     tmElements_t timeElements;
     breakTime(sunset, timeElements);
@@ -38,9 +34,25 @@ RiseAndSet getRiseAndSetTimes(const CelestialObject &object, time_t sunset)
     return times;
 }
 
+/**
+ * Whether a body's rise and set times, as getRiseAndSetTimes computes them for the
+ * day of sunset, put it above the horizon during the night; visibility is only
+ * tested against the horizon mask for such bodies.
+ *
+ * @param riseAndSet Rise and set times of the body.
+ * @param sunset Start of the night.
+ * @param sunrise End of the night.
+ */
+bool isUpAtNight(const RiseAndSet &riseAndSet, time_t sunset, time_t sunrise)
+{
+    return (sunrise > riseAndSet.setTime && sunset < riseAndSet.riseTime) ||
+           (sunrise < riseAndSet.riseTime && sunset > riseAndSet.setTime);
+}
+
 // Determine the altitude and azimuth for a celestial object at culmination.
-AlmanacData calculateAlmanacData(const CelestialObject &object, time_t riseTime, time_t setTime)
+AlmanacData calculateAlmanacData(CelestialEngine &engine, const CelestialObject &object, time_t riseTime, time_t setTime)
 {
+    SiderealPlanets &astro = engine.calculator();
     AlmanacData result;
     time_t culminationTime = riseTime + (setTime - riseTime) / 2;
     tmElements_t timeElements;
@@ -85,41 +97,210 @@ AlmanacData calculateAlmanacData(const CelestialObject &object, time_t riseTime,
     return result;
 }
 
-// Generate random AlmanacData for testing or simulation.
-AlmanacData calculateAlmanacData()
+// Generate random AlmanacData for testing or simulation; the engine must be in simulation mode.
+AlmanacData calculateAlmanacData(CelestialEngine &engine)
 {
     AlmanacData result;
-    std::uniform_real_distribution<float> altDist(-90.0f, 90.0f);
-    result.hc = altDist(gen);
-    std::uniform_real_distribution<float> aziDist(0.0f, 359.0f);
-    result.zn = aziDist(gen);
+    // The top 24 bits of each draw give a uniform float in [0, 1)
+    result.hc = -90.0f + 180.0f * (engine.nextRandom() >> 8) / 16777216.0f;
+    result.zn = 359.0f * (engine.nextRandom() >> 8) / 16777216.0f;
 
     return result;
 }
 
-// Check if a celestial body is visible within the observer's field of view.
-bool isVisible(const FieldOfView &fov, const AlmanacData &data)
+/**
+ * Switches simulation mode on or off. While it is on, computeBody takes the
+ * positions of the bodies from a generator seeded here instead of from
+ * SiderealPlanets, so the same seed and calls give the same synthetic sky.
+ * Rise and set times are still computed. Switching clears the cache, so real
+ * and synthetic results never mix.
+ *
+ * @param seed Seed of the generator; 0 switches simulation off.
+ */
+void CelestialEngine::setSimulation(uint32_t seed)
+{
+    simulationState = seed;
+    clearCache();
+}
+
+// Next value of the xorshift32 generator; its state never becomes 0 once seeded.
+uint32_t CelestialEngine::nextRandom()
+{
+    uint32_t x = simulationState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    simulationState = x;
+    return x;
+}
+
+/**
+ * Sets the parts of the horizon that are raised by obstacles. Cached results
+ * were computed against the old horizon, so changing the profile clears the cache.
+ *
+ * @param profile The raised sectors; an empty profile is a flat horizon.
+ */
+void CelestialEngine::setHorizonProfile(const HorizonProfile &profile)
+{
+    if (profile == horizon)
+    {
+        return;
+    }
+    horizon = profile;
+    mask.compile(maskFov, &horizon);
+    clearCache();
+}
+
+// Visibility table for a field of view under the current horizon profile.
+const HorizonMask &CelestialEngine::horizonMask(const FieldOfView &fov)
+{
+    if (fov.leftBound != maskFov.leftBound || fov.rightBound != maskFov.rightBound)
+    {
+        maskFov = fov;
+        mask.compile(maskFov, &horizon);
+    }
+    return mask;
+}
+
+CelestialEngine::CacheKey CelestialEngine::makeCacheKey(const GeoLocation &location, time_t sunset, const FieldOfView &fov) const
 {
-    if (data.hc <= 0)
-        return false;
+    CacheKey key;
+    key.night = static_cast<long>(sunset / SECS_PER_DAY);
+    key.latitude = lroundf(location.latitude / cachePrecision);
+    key.longitude = lroundf(location.longitude / cachePrecision);
+    key.leftBound = fov.leftBound;
+    key.rightBound = fov.rightBound;
+    return key;
+}
 
-    if (fov.leftBound == 0 && fov.rightBound == 360)
-        return true;
+bool CelestialEngine::CacheKey::operator==(const CacheKey &other) const
+{
+    return night == other.night && latitude == other.latitude && longitude == other.longitude &&
+           leftBound == other.leftBound && rightBound == other.rightBound;
+}
 
-    uint16_t normalizedZN = static_cast<uint16_t>(round(fmod(data.zn, 360.0)));
-    uint16_t normalizedLeftBound = fov.leftBound % 360;
-    uint16_t normalizedRightBound = fov.rightBound % 360;
+/**
+ * Sets the grid the location is snapped to before looking up the ephemeris cache.
+ * Locations in the same grid cell share one cached result. Changing the precision clears the cache.
+ *
+ * @param degrees Cell size in degrees of latitude and longitude; non-positive values select the default.
+ */
+void CelestialEngine::setCachePrecision(float degrees)
+{
+    cachePrecision = degrees > 0 ? degrees : CELESTIAL_CACHE_DEFAULT_PRECISION;
+    clearCache();
+}
 
-    return (normalizedZN >= normalizedLeftBound && normalizedZN <= normalizedRightBound) ||
-           (normalizedLeftBound > normalizedRightBound &&
-            (normalizedZN >= normalizedLeftBound || normalizedZN <= normalizedRightBound));
+// Drops all cached results; the counters are kept.
+void CelestialEngine::clearCache()
+{
+    for (auto &entry : cacheEntries)
+    {
+        entry.isValid = false;
+    }
+}
+
+/**
+ * Looks up a CelestialInfo computed earlier for the same night, quantized location and field of view.
+ *
+ * @param info Receives the cached result on a hit; untouched on a miss.
+ * @param location The geographical coordinates where observations are made.
+ * @param sunset The expected time of the next sunset at the given location.
+ * @param fov The field of view from the observer's location.
+ * @return true on a cache hit.
+ */
+bool CelestialEngine::findCached(CelestialInfo &info, const GeoLocation &location, time_t sunset, const FieldOfView &fov)
+{
+    const CacheKey key = makeCacheKey(location, sunset, fov);
+    for (auto &entry : cacheEntries)
+    {
+        if (entry.isValid && entry.key == key)
+        {
+            entry.lastUsed = ++cacheClock;
+            info = entry.info;
+            cacheStats.hits++;
+            return true;
+        }
+    }
+    cacheStats.misses++;
+    return false;
+}
+
+/**
+ * Stores a computed CelestialInfo, replacing the least recently used entry.
+ * The arguments must be the ones the result was computed with.
+ */
+void CelestialEngine::storeCached(const CelestialInfo &info, const GeoLocation &location, time_t sunset, const FieldOfView &fov)
+{
+    CacheEntry *victim = &cacheEntries[0];
+    for (auto &entry : cacheEntries)
+    {
+        if (!entry.isValid)
+        {
+            victim = &entry;
+            break;
+        }
+        if (entry.lastUsed < victim->lastUsed)
+        {
+            victim = &entry;
+        }
+    }
+    victim->isValid = true;
+    victim->lastUsed = ++cacheClock;
+    victim->key = makeCacheKey(location, sunset, fov);
+    victim->info = info;
+}
+
+/**
+ * Prepares a CelestialInfo for computation at a given location.
+ * Together with `computeBody` this lets callers spread the work for the
+ * individual bodies over several steps instead of computing all of them at once.
+ *
+ * @param info The struct to initialize; its bodies are filled by computeBody.
+ * @param location The geographical coordinates where observations are made.
+ */
+void CelestialEngine::begin(CelestialInfo &info, const GeoLocation &location)
+{
+    astro.setLatLong(location.latitude, location.longitude);
+    info.bodyCount = MAX_CELESTIAL_BODIES;
+}
+
+/**
+ * Computes rise and set times, culmination position and visibility of one body.
+ * The location is the one passed to the preceding `begin`.
+ *
+ * @param info The struct prepared by begin.
+ * @param index The body to compute, 0 to MAX_CELESTIAL_BODIES - 1 in CelestialObject order.
+ * @param sunset The expected time of the next sunset at the given location.
+ * @param sunrise The expected time of the next sunrise at the given location.
+ * @param fov The field of view from the observer's location.
+ */
+void CelestialEngine::computeBody(CelestialInfo &info, uint8_t index, time_t sunset, time_t sunrise, const FieldOfView &fov)
+{
+    CelestialBodyInfo &body = info.bodies[index];
+    body.object = static_cast<CelestialObject>(index);
+    strncpy(body.name, celestialObjectName(body.object), sizeof(body.name) - 1);
+    body.name[sizeof(body.name) - 1] = '\0';
+    RiseAndSet riseAndSet;
+    {
+        ScopedLatency timer(LATENCY_RISE_AND_SET);
+        riseAndSet = getRiseAndSetTimes(*this, body.object, sunset);
+    }
+    body.riseAndSet = riseAndSet;
+    {
+        ScopedLatency timer(LATENCY_ALMANAC);
+        body.positionCulmination = isSimulating() ? calculateAlmanacData(*this)
+                                                  : calculateAlmanacData(*this, body.object, body.riseAndSet.riseTime, body.riseAndSet.setTime);
+    }
+    body.isVisible = isUpAtNight(riseAndSet, sunset, sunrise) && horizonMask(fov).isVisible(body.positionCulmination);
 }
 
 /**
  * Retrieves information about celestial bodies based on a given geographical location, times of sunset and sunrise, and the observer's field of view.
- * The function initializes the SiderealPlanets object with the provided location to perform astronomical calculations.
+ * The engine's SiderealPlanets calculator is initialized with the provided location to perform astronomical calculations.
  * It calculates the rise and set times for the celestial bodies using `getRiseAndSetTimes` and determines their culminating position using `calculateAlmanacData`.
- * Visibility of each celestial body within the specified field of view is assessed using the `isVisible` function.
+ * Visibility of each celestial body within the specified field of view and above the horizon profile is assessed with the engine's HorizonMask.
+ * Results are cached per night and quantized location, so repeated calls for the same night skip the computation.
  *
  * @param location The geographical coordinates where observations are made.
  * @param sunset The expected time of the next sunset at the given location.
@@ -127,30 +308,71 @@ bool isVisible(const FieldOfView &fov, const AlmanacData &data)
  * @param fov The field of view from the observer's location.
  * @return CelestialInfo A struct containing an array of CelestialBodyInfo for each body, and the count of bodies.
  */
-CelestialInfo getCelestialInfo(const GeoLocation &location, time_t sunset, time_t sunrise, const FieldOfView &fov)
+CelestialInfo CelestialEngine::compute(const GeoLocation &location, time_t sunset, time_t sunrise, const FieldOfView &fov)
 {
-    initSiderealPlanets(location);
-
     CelestialInfo info;
-    info.bodyCount = MAX_CELESTIAL_BODIES;
+    if (findCached(info, location, sunset, fov))
+    {
+        return info;
+    }
 
+    begin(info, location);
     for (int i = 0; i < MAX_CELESTIAL_BODIES; ++i)
     {
-        strncpy(info.bodies[i].name, names[i], sizeof(info.bodies[i].name) - 1);
-        info.bodies[i].name[sizeof(info.bodies[i].name) - 1] = '\0';
-        RiseAndSet riseAndSet = getRiseAndSetTimes(static_cast<CelestialObject>(i), sunset);
-        info.bodies[i].riseAndSet = riseAndSet;
-        info.bodies[i].positionCulmination = calculateAlmanacData(static_cast<CelestialObject>(i), info.bodies[i].riseAndSet.riseTime, info.bodies[i].riseAndSet.setTime);
-        if ((sunrise > riseAndSet.setTime && sunset < riseAndSet.riseTime) ||
-            (sunrise < riseAndSet.riseTime && sunset > riseAndSet.setTime))
-        {
-            info.bodies[i].isVisible = isVisible(fov, info.bodies[i].positionCulmination);
-        }
-        else
-        {
-            info.bodies[i].isVisible = false;
-        }
-        info.bodies[i].isVisible = true;
+        computeBody(info, i, sunset, sunrise, fov);
     }
+    storeCached(info, location, sunset, fov);
     return info;
 }
+
+// The free functions below act on the default engine.
+
+void setCelestialCachePrecision(float degrees)
+{
+    defaultCelestialEngine().setCachePrecision(degrees);
+}
+
+void clearCelestialCache()
+{
+    defaultCelestialEngine().clearCache();
+}
+
+CelestialCacheStats getCelestialCacheStats()
+{
+    return defaultCelestialEngine().getCacheStats();
+}
+
+void setHorizonProfile(const HorizonProfile &profile)
+{
+    defaultCelestialEngine().setHorizonProfile(profile);
+}
+
+const HorizonProfile &getHorizonProfile()
+{
+    return defaultCelestialEngine().horizonProfile();
+}
+
+bool findCachedCelestialInfo(CelestialInfo &info, const GeoLocation &location, time_t sunset, const FieldOfView &fov)
+{
+    return defaultCelestialEngine().findCached(info, location, sunset, fov);
+}
+
+void storeCachedCelestialInfo(const CelestialInfo &info, const GeoLocation &location, time_t sunset, const FieldOfView &fov)
+{
+    defaultCelestialEngine().storeCached(info, location, sunset, fov);
+}
+
+void beginCelestialInfo(CelestialInfo &info, const GeoLocation &location)
+{
+    defaultCelestialEngine().begin(info, location);
+}
+
+void computeCelestialBody(CelestialInfo &info, uint8_t index, time_t sunset, time_t sunrise, const FieldOfView &fov)
+{
+    defaultCelestialEngine().computeBody(info, index, sunset, sunrise, fov);
+}
+
+CelestialInfo getCelestialInfo(const GeoLocation &location, time_t sunset, time_t sunrise, const FieldOfView &fov)
+{
+    return defaultCelestialEngine().compute(location, sunset, sunrise, fov);
+}
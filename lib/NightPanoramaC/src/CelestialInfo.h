@@ -1,14 +1,10 @@
 #ifndef CELESTIALINFO_H
 #define CELESTIALINFO_H
 
+#include <SiderealPlanets.h>
+#include "HorizonMask.h"
 #include "SharedStructs.h"
 
-struct AlmanacData
-{
-    float hc;
-    float zn;
-};
-
 struct RiseAndSet
 {
     time_t riseTime;
@@ -17,6 +13,7 @@ struct RiseAndSet
 
 struct CelestialBodyInfo
 {
+    CelestialObject object;
     char name[10];
     RiseAndSet riseAndSet;
     AlmanacData positionCulmination;
@@ -32,6 +29,103 @@ struct CelestialInfo
     uint8_t bodyCount;
 };
 
+// Ephemeris cache: results are reused while the night, the quantized location and the FOV stay the same
+const float CELESTIAL_CACHE_DEFAULT_PRECISION = 0.01; // Degrees of latitude/longitude, about 1 km
+const uint8_t CELESTIAL_CACHE_ENTRIES = 2;
+
+struct CelestialCacheStats
+{
+    uint32_t hits;
+    uint32_t misses;
+};
+
+/**
+ * Owns everything a celestial computation mutates: the SiderealPlanets
+ * calculator, the ephemeris cache, the horizon mask and, in simulation mode,
+ * the generator for synthetic positions. Engines share no state, so separate engines can compute
+ * different locations concurrently, and one engine can be driven step by step
+ * (beginCelestialInfo/computeBody) between other work.
+ */
+class CelestialEngine
+{
+public:
+    CelestialEngine();
+
+    void begin(CelestialInfo &info, const GeoLocation &location);
+    void computeBody(CelestialInfo &info, uint8_t index, time_t sunset, time_t sunrise, const FieldOfView &fov);
+    CelestialInfo compute(const GeoLocation &location, time_t sunset, time_t sunrise, const FieldOfView &fov);
+
+    void setCachePrecision(float degrees);
+    void clearCache();
+    CelestialCacheStats getCacheStats() const { return cacheStats; }
+    bool findCached(CelestialInfo &info, const GeoLocation &location, time_t sunset, const FieldOfView &fov);
+    void storeCached(const CelestialInfo &info, const GeoLocation &location, time_t sunset, const FieldOfView &fov);
+
+    void setSimulation(uint32_t seed);
+    bool isSimulating() const { return simulationState != 0; }
+    uint32_t nextRandom();
+
+    void setHorizonProfile(const HorizonProfile &profile);
+    const HorizonProfile &horizonProfile() const { return horizon; }
+    const HorizonMask &horizonMask(const FieldOfView &fov);
+
+    SiderealPlanets &calculator() { return astro; }
+
+private:
+    // Identifies the inputs a cached CelestialInfo was computed for.
+    struct CacheKey
+    {
+        long night; // UTC day of the sunset; rise and set times are computed for this date
+        long latitude;
+        long longitude;
+        uint16_t leftBound;
+        uint16_t rightBound;
+
+        bool operator==(const CacheKey &other) const;
+    };
+
+    struct CacheEntry
+    {
+        bool isValid;
+        uint32_t lastUsed;
+        CacheKey key;
+        CelestialInfo info;
+    };
+
+    CacheKey makeCacheKey(const GeoLocation &location, time_t sunset, const FieldOfView &fov) const;
+
+    SiderealPlanets astro;
+    uint32_t simulationState; // xorshift32 state; 0 while simulation is off
+
+    // The mask is recompiled only when the field of view or the profile changes
+    HorizonProfile horizon;
+    HorizonMask mask;
+    FieldOfView maskFov;
+
+    CacheEntry cacheEntries[CELESTIAL_CACHE_ENTRIES];
+    CelestialCacheStats cacheStats;
+    float cachePrecision;
+    uint32_t cacheClock;
+};
+
+// Engine behind the functions below, for callers that need only one.
+CelestialEngine &defaultCelestialEngine();
+
+RiseAndSet getRiseAndSetTimes(CelestialEngine &engine, const CelestialObject &object, time_t sunset);
+bool isUpAtNight(const RiseAndSet &riseAndSet, time_t sunset, time_t sunrise);
+AlmanacData calculateAlmanacData(CelestialEngine &engine, const CelestialObject &object, time_t riseTime, time_t setTime);
+AlmanacData calculateAlmanacData(CelestialEngine &engine);
+
+void setCelestialCachePrecision(float degrees);
+void clearCelestialCache();
+CelestialCacheStats getCelestialCacheStats();
+void setHorizonProfile(const HorizonProfile &profile);
+const HorizonProfile &getHorizonProfile();
+bool findCachedCelestialInfo(CelestialInfo &info, const GeoLocation &location, time_t sunset, const FieldOfView &fov);
+void storeCachedCelestialInfo(const CelestialInfo &info, const GeoLocation &location, time_t sunset, const FieldOfView &fov);
+
+void beginCelestialInfo(CelestialInfo &info, const GeoLocation &location);
+void computeCelestialBody(CelestialInfo &info, uint8_t index, time_t sunset, time_t sunrise, const FieldOfView &fov);
 CelestialInfo getCelestialInfo(const GeoLocation &location, time_t sunset, time_t sunrise, const FieldOfView &fov);
 
 #endif // CELESTIALINFO_H
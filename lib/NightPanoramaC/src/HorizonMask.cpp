@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HorizonMask.h"
+
+bool HorizonProfile::operator==(const HorizonProfile &other) const
+{
+    if (sectorCount != other.sectorCount)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < sectorCount; i++)
+    {
+        const HorizonSector &a = sectors[i];
+        const HorizonSector &b = other.sectors[i];
+        if (a.from != b.from || a.to != b.to || a.minAltitude != b.minAltitude)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+HorizonMask::HorizonMask()
+{
+    compile({0, 360});
+}
+
+/**
+ * Rebuilds the table. Inside the field of view the horizon is flat (0 degrees)
+ * unless a sector of the profile raises it; where sectors overlap the higher one
+ * counts. Outside the field of view nothing is visible.
+ *
+ * @param fov Azimuth range, both bounds included; it wraps through north when the
+ *            left bound is the larger one, and 0 to 360 means all around.
+ * @param profile Raised parts of the horizon, or nullptr for a flat horizon.
+ */
+void HorizonMask::compile(const FieldOfView &fov, const HorizonProfile *profile)
+{
+    const bool isFull = fov.leftBound == 0 && fov.rightBound == 360;
+    const uint16_t left = fov.leftBound % 360;
+    const uint16_t right = fov.rightBound % 360;
+    for (uint16_t azimuth = 0; azimuth < 360; azimuth++)
+    {
+        const bool isInside = isFull || (left <= right ? azimuth >= left && azimuth <= right
+                                                       : azimuth >= left || azimuth <= right);
+        table[azimuth] = isInside ? 0 : BLOCKED;
+    }
+
+    for (uint8_t i = 0; profile != nullptr && i < profile->sectorCount; i++)
+    {
+        const HorizonSector &sector = profile->sectors[i];
+        for (uint16_t azimuth = sector.from % 360;; azimuth = (azimuth + 1) % 360)
+        {
+            if (sector.minAltitude > table[azimuth])
+            {
+                table[azimuth] = sector.minAltitude;
+            }
+            if (azimuth == sector.to % 360)
+            {
+                break;
+            }
+        }
+    }
+    table[360] = table[0];
+}
+
+/**
+ * Reads a horizon profile as entered on the web page: comma-separated sectors
+ * "from-to:altitude" in whole degrees, e.g. "80-130:25,300-20:10". An empty
+ * text is a flat horizon.
+ *
+ * @param text The profile text.
+ * @param profile Receives the sectors; left untouched when false is returned.
+ * @return false if a sector is malformed, out of range or there are more than HORIZON_MAX_SECTORS.
+ */
+bool parseHorizonProfile(const char *text, HorizonProfile &profile)
+{
+    HorizonProfile result = {};
+    const char *cursor = text;
+    while (*cursor == ' ')
+    {
+        cursor++;
+    }
+    while (*cursor != '\0')
+    {
+        char *end;
+        const long from = strtol(cursor, &end, 10);
+        if (end == cursor || *end != '-')
+        {
+            return false;
+        }
+        cursor = end + 1;
+        const long to = strtol(cursor, &end, 10);
+        if (end == cursor || *end != ':')
+        {
+            return false;
+        }
+        cursor = end + 1;
+        const long altitude = strtol(cursor, &end, 10);
+        if (end == cursor || from < 0 || from > 359 || to < 0 || to > 359 || altitude < 0 ||
+            altitude > HORIZON_MAX_ALTITUDE || result.sectorCount == HORIZON_MAX_SECTORS)
+        {
+            return false;
+        }
+        result.sectors[result.sectorCount++] = {static_cast<uint16_t>(from), static_cast<uint16_t>(to),
+                                                static_cast<uint8_t>(altitude)};
+
+        cursor = end;
+        while (*cursor == ' ')
+        {
+            cursor++;
+        }
+        if (*cursor == ',')
+        {
+            cursor++;
+            while (*cursor == ' ')
+            {
+                cursor++;
+            }
+        }
+        else if (*cursor != '\0')
+        {
+            return false;
+        }
+    }
+    profile = result;
+    return true;
+}
+
+/**
+ * Writes a profile in the form parseHorizonProfile reads.
+ *
+ * @return The length of the text, or the length it would have had if it was truncated.
+ */
+int formatHorizonProfile(char *buffer, size_t size, const HorizonProfile &profile)
+{
+    int length = 0;
+    if (size > 0)
+    {
+        buffer[0] = '\0';
+    }
+    for (uint8_t i = 0; i < profile.sectorCount; i++)
+    {
+        const HorizonSector &sector = profile.sectors[i];
+        const size_t offset = static_cast<size_t>(length) < size ? static_cast<size_t>(length) : size;
+        length += snprintf(buffer + offset, size - offset, "%s%u-%u:%u", i > 0 ? "," : "", sector.from, sector.to,
+                           sector.minAltitude);
+    }
+    return length;
+}
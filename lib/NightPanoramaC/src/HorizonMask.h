@@ -0,0 +1,62 @@
+#ifndef HORIZONMASK_H
+#define HORIZONMASK_H
+
+#include <stddef.h>
+#include "SharedStructs.h"
+
+// Stretch of the horizon hidden up to some altitude by trees, buildings or mountains.
+struct HorizonSector
+{
+    uint16_t from;       // First azimuth in degrees, 0-359
+    uint16_t to;         // Last azimuth in degrees, inclusive; smaller than from when the sector wraps through north
+    uint8_t minAltitude; // Degrees; a body must be higher than this to be seen
+};
+
+const uint8_t HORIZON_MAX_SECTORS = 8;
+const uint8_t HORIZON_MAX_ALTITUDE = 90;
+const size_t HORIZON_TEXT_SIZE = HORIZON_MAX_SECTORS * 12 + 1; // "359-359:90," per sector
+
+// Horizon as configured: the sectors that rise above the flat horizon.
+struct HorizonProfile
+{
+    HorizonSector sectors[HORIZON_MAX_SECTORS];
+    uint8_t sectorCount;
+
+    bool operator==(const HorizonProfile &other) const;
+};
+
+/**
+ * Lowest visible altitude for every whole degree of azimuth, compiled from a
+ * field of view and a horizon profile. Azimuths outside the field of view get
+ * an altitude no body can exceed, so a visibility test is one table read and
+ * one compare, with no wrap-around arithmetic.
+ */
+class HorizonMask
+{
+public:
+    HorizonMask();
+
+    void compile(const FieldOfView &fov, const HorizonProfile *profile = nullptr);
+
+    uint8_t minAltitude(uint16_t azimuth) const { return table[azimuth]; }
+
+    /**
+     * @param data Position with the azimuth in [0, 360).
+     * @return true if the body stands above the horizon at its azimuth and inside the field of view.
+     */
+    bool isVisible(const AlmanacData &data) const
+    {
+        return data.hc > table[static_cast<uint16_t>(data.zn + 0.5f)];
+    }
+
+private:
+    static const uint8_t BLOCKED = HORIZON_MAX_ALTITUDE; // No altitude is above the zenith
+
+    // One entry per degree; the last repeats north, so azimuths that round up to 360 need no wrap
+    uint8_t table[361];
+};
+
+bool parseHorizonProfile(const char *text, HorizonProfile &profile);
+int formatHorizonProfile(char *buffer, size_t size, const HorizonProfile &profile);
+
+#endif // HORIZONMASK_H
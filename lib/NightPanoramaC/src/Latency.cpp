@@ -0,0 +1,46 @@
+#include "Latency.h"
+
+const uint32_t LatencyHistogram::BUCKET_BOUNDS_US[BUCKET_COUNT] = {
+    10, 30, 100, 300, 1000, 3000, 10000, 30000, 100000, 300000, 1000000, 3000000};
+
+const char *const LatencyHistogram::BUCKET_LABELS[BUCKET_COUNT] = {
+    "0.00001", "0.00003", "0.0001", "0.0003", "0.001", "0.003", "0.01", "0.03", "0.1", "0.3", "1", "3"};
+
+LatencyHistogram *LatencyHistogram::head = nullptr;
+
+// Defined in one translation unit so the list order, and thus the export order, is fixed.
+LatencyHistogram LATENCY_RESOLVE("resolve");
+LatencyHistogram LATENCY_CONNECT("connect");
+LatencyHistogram LATENCY_HTTP_GET("http_get");
+LatencyHistogram LATENCY_HEADERS("headers");
+LatencyHistogram LATENCY_BODY_READ("body_read");
+LatencyHistogram LATENCY_PARSE("parse");
+LatencyHistogram LATENCY_NIGHT_SELECT("night_select");
+LatencyHistogram LATENCY_AGGREGATE("aggregate");
+LatencyHistogram LATENCY_RISE_AND_SET("rise_and_set");
+LatencyHistogram LATENCY_ALMANAC("almanac");
+LatencyHistogram LATENCY_TIMELINE("timeline");
+
+LatencyHistogram::LatencyHistogram(const char *phase)
+    : phaseName(phase), nextHistogram(head), sampleCount(0), totalMicros(0), buckets{}
+{
+    head = this;
+}
+
+/**
+ * Adds one duration to the histogram.
+ *
+ * @param ticks Duration in latencyTicks() units; the counter wraps after about 53 s at 80 MHz.
+ */
+void LatencyHistogram::record(uint32_t ticks)
+{
+    const uint32_t us = ticks / latencyTicksPerMicrosecond();
+    uint8_t index = 0;
+    while (index < BUCKET_COUNT && us > BUCKET_BOUNDS_US[index])
+    {
+        index++;
+    }
+    buckets[index]++;
+    sampleCount++;
+    totalMicros += us;
+}
@@ -0,0 +1,103 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <Arduino.h>
+
+#ifdef NIGHTPANORAMAC_HOST
+#include <atomic>
+// Batch workers on the host record from several threads at once
+typedef std::atomic<uint32_t> LatencyCounter;
+typedef std::atomic<uint64_t> LatencyTotal;
+#else
+typedef uint32_t LatencyCounter;
+typedef uint64_t LatencyTotal;
+#endif
+
+// Free-running counter for timing phases: CPU cycles on the ESP8266, microseconds on the host.
+inline uint32_t latencyTicks()
+{
+#ifdef ESP8266
+    return ESP.getCycleCount();
+#else
+    return micros();
+#endif
+}
+
+inline uint32_t latencyTicksPerMicrosecond()
+{
+#ifdef ESP8266
+    return ESP.getCpuFreqMHz();
+#else
+    return 1;
+#endif
+}
+
+/**
+ * Fixed-bucket histogram of the duration of one phase.
+ * Every histogram links itself into a global list on construction, so an
+ * exporter can walk all of them without knowing which modules define phases.
+ * Recording is a subtraction, a division and a scan of the bucket bounds; no
+ * allocation, no floating point.
+ */
+class LatencyHistogram
+{
+public:
+    static const uint8_t BUCKET_COUNT = 12;
+
+    // Upper bounds of the buckets in microseconds; one more bucket counts everything above the last.
+    static const uint32_t BUCKET_BOUNDS_US[BUCKET_COUNT];
+
+    // Upper bounds in seconds as Prometheus "le" labels, matching BUCKET_BOUNDS_US.
+    static const char *const BUCKET_LABELS[BUCKET_COUNT];
+
+    explicit LatencyHistogram(const char *phase);
+
+    void record(uint32_t ticks);
+
+    const char *phase() const { return phaseName; }
+    uint32_t count() const { return sampleCount; }
+    uint64_t sumMicros() const { return totalMicros; }
+    uint32_t bucket(uint8_t index) const { return buckets[index]; } // Not cumulative; index BUCKET_COUNT is the overflow
+
+    static LatencyHistogram *first() { return head; }
+    LatencyHistogram *next() const { return nextHistogram; }
+
+private:
+    static LatencyHistogram *head;
+
+    const char *phaseName;
+    LatencyHistogram *nextHistogram;
+    LatencyCounter sampleCount;
+    LatencyTotal totalMicros;
+    LatencyCounter buckets[BUCKET_COUNT + 1];
+};
+
+// Records the time from construction to the end of the enclosing scope.
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyHistogram &histogram) : histogram(histogram), start(latencyTicks()) {}
+    ~ScopedLatency() { histogram.record(latencyTicks() - start); }
+
+    ScopedLatency(const ScopedLatency &) = delete;
+    ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+private:
+    LatencyHistogram &histogram;
+    uint32_t start;
+};
+
+// Phases of getStargazingInfo and StargazingFetcher.
+extern LatencyHistogram LATENCY_RESOLVE;       // DNS lookup of the API host, when not cached
+extern LatencyHistogram LATENCY_CONNECT;       // TCP connect
+extern LatencyHistogram LATENCY_HTTP_GET;      // Sending the request (and, for getWeatherInfo, waiting for the status line)
+extern LatencyHistogram LATENCY_HEADERS;       // Reading response headers
+extern LatencyHistogram LATENCY_BODY_READ;     // Reading one piece of the body off the socket
+extern LatencyHistogram LATENCY_PARSE;         // Feeding one piece of the body to WeatherParser
+extern LatencyHistogram LATENCY_NIGHT_SELECT;  // Picking the next sunset/sunrise pair
+extern LatencyHistogram LATENCY_AGGREGATE;     // Rain, cloud cover and dew loops over the hourly samples
+extern LatencyHistogram LATENCY_RISE_AND_SET;  // getRiseAndSetTimes for one body
+extern LatencyHistogram LATENCY_ALMANAC;       // calculateAlmanacData for one body
+extern LatencyHistogram LATENCY_TIMELINE;      // computeNightTimeline for all bodies
+
+#endif // LATENCY_H
@@ -3,6 +3,8 @@
 
 #include "WeatherInfo.h"
 #include "CelestialInfo.h"
+#include "HorizonMask.h"
 #include "StargazingInfo.h"
+#include "NightTimeline.h"
 
 #endif // NIGHTPANORAMA_PLUSPLUS_H
@@ -0,0 +1,280 @@
+#include <math.h>
+#include "Latency.h"
+#include "NightTimeline.h"
+
+// Orbital elements after Paul Schlyter, "How to compute planetary positions":
+// each element is value + rate * d, with d in days since 2000 Jan 0.0 UT.
+struct OrbitalElements
+{
+    double node, nodeRate;                   // Longitude of the ascending node, degrees
+    double inclination, inclinationRate;     // Degrees
+    double perihelion, perihelionRate;       // Argument of perihelion (perigee for the Moon), degrees
+    double semiMajorAxis, semiMajorAxisRate; // AU; Earth radii for the Moon
+    double eccentricity, eccentricityRate;
+    double meanAnomaly, meanAnomalyRate;     // Degrees
+};
+
+// In CelestialObject order
+static const OrbitalElements ELEMENTS[MAX_CELESTIAL_BODIES] = {
+    {125.1228, -0.0529538083, 5.1454, 0, 318.0634, 0.1643573223, 60.2666, 0, 0.054900, 0, 115.3654, 13.0649929509},
+    {48.3313, 3.24587e-5, 7.0047, 5.00e-8, 29.1241, 1.01444e-5, 0.387098, 0, 0.205635, 5.59e-10, 168.6562, 4.0923344368},
+    {76.6799, 2.46590e-5, 3.3946, 2.75e-8, 54.8910, 1.38374e-5, 0.723330, 0, 0.006773, -1.302e-9, 48.0052, 1.6021302244},
+    {49.5574, 2.11081e-5, 1.8497, -1.78e-8, 286.5016, 2.92961e-5, 1.523688, 0, 0.093405, 2.516e-9, 18.6021, 0.5240207766},
+    {100.4542, 2.76854e-5, 1.3030, -1.557e-7, 273.8777, 1.64505e-5, 5.20256, 0, 0.048498, 4.469e-9, 19.8950, 0.0830853001},
+    {113.6634, 2.38980e-5, 2.4886, -1.081e-7, 339.3939, 2.97661e-5, 9.55475, 0, 0.055546, -9.499e-9, 316.9670, 0.0334442282},
+    {74.0005, 1.3978e-5, 0.7733, 1.9e-8, 96.6612, 3.0565e-5, 19.18171, -1.55e-8, 0.047318, 7.45e-9, 142.5905, 0.011725806},
+    {131.7806, 3.0173e-5, 1.7700, -2.55e-7, 272.8461, -6.027e-6, 30.05826, 3.313e-8, 0.008606, 2.15e-9, 260.2471, 0.005995147}};
+
+// Unix time of 2000 Jan 0.0 UT, the epoch of the elements
+const time_t ELEMENTS_EPOCH = 946598400;
+
+static double normalizeDegrees(double degrees)
+{
+    degrees = fmod(degrees, 360.0);
+    return degrees < 0 ? degrees + 360.0 : degrees;
+}
+
+static double sinDeg(double degrees) { return sin(radians(degrees)); }
+static double cosDeg(double degrees) { return cos(radians(degrees)); }
+
+// Everything that depends only on the time and the observer, shared by all bodies of a step.
+struct StepContext
+{
+    double d;
+    double sunX, sunY;       // Geocentric ecliptic position of the Sun, AU
+    double sunMeanAnomaly;   // Degrees
+    double sunMeanLongitude; // Degrees
+    double sinObliquity, cosObliquity;
+    double siderealTime;     // Local sidereal time, degrees
+    double cosSiderealTime, sinSiderealTime;
+    double sinLatitude, cosLatitude;
+    double jupiterMeanAnomaly, saturnMeanAnomaly; // For the mutual perturbations of Jupiter and Saturn
+};
+
+// Solves Kepler's equation; returns the eccentric anomaly in degrees.
+static double eccentricAnomaly(double meanAnomaly, double eccentricity)
+{
+    double e = meanAnomaly + degrees(eccentricity) * sinDeg(meanAnomaly) * (1.0 + eccentricity * cosDeg(meanAnomaly));
+    if (eccentricity > 0.05)
+    {
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            e -= (e - degrees(eccentricity) * sinDeg(e) - meanAnomaly) / (1.0 - eccentricity * cosDeg(e));
+        }
+    }
+    return e;
+}
+
+static void beginStep(StepContext &step, time_t time, double longitude)
+{
+    step.d = static_cast<double>(time - ELEMENTS_EPOCH) / SECS_PER_DAY;
+
+    const double obliquity = 23.4393 - 3.563e-7 * step.d;
+    step.sinObliquity = sinDeg(obliquity);
+    step.cosObliquity = cosDeg(obliquity);
+
+    const double perihelion = 282.9404 + 4.70935e-5 * step.d;
+    const double eccentricity = 0.016709 - 1.151e-9 * step.d;
+    step.sunMeanAnomaly = normalizeDegrees(356.0470 + 0.9856002585 * step.d);
+    step.sunMeanLongitude = normalizeDegrees(step.sunMeanAnomaly + perihelion);
+
+    const double e = eccentricAnomaly(step.sunMeanAnomaly, eccentricity);
+    const double xv = cosDeg(e) - eccentricity;
+    const double yv = sqrt(1.0 - eccentricity * eccentricity) * sinDeg(e);
+    const double distance = sqrt(xv * xv + yv * yv);
+    const double longitudeSun = degrees(atan2(yv, xv)) + perihelion;
+    step.sunX = distance * cosDeg(longitudeSun);
+    step.sunY = distance * sinDeg(longitudeSun);
+
+    const double hoursUt = fmod(static_cast<double>(time), SECS_PER_DAY) / SECS_PER_HOUR;
+    step.siderealTime = normalizeDegrees(step.sunMeanLongitude + 180.0 + hoursUt * 15.0 + longitude);
+    step.cosSiderealTime = cosDeg(step.siderealTime);
+    step.sinSiderealTime = sinDeg(step.siderealTime);
+
+    step.jupiterMeanAnomaly = normalizeDegrees(ELEMENTS[Jupiter].meanAnomaly + ELEMENTS[Jupiter].meanAnomalyRate * step.d);
+    step.saturnMeanAnomaly = normalizeDegrees(ELEMENTS[Saturn].meanAnomaly + ELEMENTS[Saturn].meanAnomalyRate * step.d);
+}
+
+// Ecliptic longitude and latitude corrections (degrees) and distance correction (Earth radii) of the Moon.
+static void perturbMoon(const StepContext &step, double meanAnomaly, double node, double perihelion,
+                        double &longitude, double &latitude, double &distance)
+{
+    const double ms = step.sunMeanAnomaly;
+    const double mm = meanAnomaly;
+    const double lm = node + perihelion + mm;
+    const double elongation = lm - step.sunMeanLongitude;
+    const double argument = lm - node;
+
+    longitude += -1.274 * sinDeg(mm - 2 * elongation) + 0.658 * sinDeg(2 * elongation) - 0.186 * sinDeg(ms) -
+                 0.059 * sinDeg(2 * mm - 2 * elongation) - 0.057 * sinDeg(mm - 2 * elongation + ms) +
+                 0.053 * sinDeg(mm + 2 * elongation) + 0.046 * sinDeg(2 * elongation - ms) +
+                 0.041 * sinDeg(mm - ms) - 0.035 * sinDeg(elongation) - 0.031 * sinDeg(mm + ms);
+    latitude += -0.173 * sinDeg(argument - 2 * elongation) - 0.055 * sinDeg(mm - argument - 2 * elongation) -
+                0.046 * sinDeg(mm + argument - 2 * elongation) + 0.033 * sinDeg(argument + 2 * elongation);
+    distance += -0.58 * cosDeg(mm - 2 * elongation) - 0.46 * cosDeg(2 * elongation);
+}
+
+// Orbit of one body over a night. The orientation of the orbit drifts by well under
+// a hundredth of a degree per night (0.1 degree for the Moon), so it is evaluated once,
+// at the middle of the night; only the mean anomaly advances per step.
+struct NightOrbit
+{
+    double node;       // Degrees
+    double perihelion; // Degrees
+    double cosNode, sinNode;
+    double cosInclination, sinInclination;
+    double semiMajorAxis;
+    double eccentricity;
+    double minorAxisFactor; // sqrt(1 - e^2)
+};
+
+static void beginOrbit(NightOrbit &orbit, const OrbitalElements &el, double d)
+{
+    orbit.node = el.node + el.nodeRate * d;
+    orbit.perihelion = el.perihelion + el.perihelionRate * d;
+    const double inclination = el.inclination + el.inclinationRate * d;
+    orbit.cosNode = cosDeg(orbit.node);
+    orbit.sinNode = sinDeg(orbit.node);
+    orbit.cosInclination = cosDeg(inclination);
+    orbit.sinInclination = sinDeg(inclination);
+    orbit.semiMajorAxis = el.semiMajorAxis + el.semiMajorAxisRate * d;
+    orbit.eccentricity = el.eccentricity + el.eccentricityRate * d;
+    orbit.minorAxisFactor = sqrt(1.0 - orbit.eccentricity * orbit.eccentricity);
+}
+
+/**
+ * Position of one body at the step, as seen from the observer.
+ *
+ * @param step The shared quantities of the step, from beginStep.
+ * @param orbit The body's orbit for the night, from beginOrbit.
+ * @param object The body.
+ * @return Altitude and azimuth in degrees.
+ */
+static AlmanacData bodyPosition(const StepContext &step, const NightOrbit &orbit, CelestialObject object)
+{
+    const OrbitalElements &el = ELEMENTS[object];
+    const double meanAnomaly = normalizeDegrees(el.meanAnomaly + el.meanAnomalyRate * step.d);
+
+    // Position in the orbit, then in ecliptic coordinates centred on the Sun (the Earth for the Moon)
+    const double e = eccentricAnomaly(meanAnomaly, orbit.eccentricity);
+    const double xv = orbit.semiMajorAxis * (cosDeg(e) - orbit.eccentricity);
+    const double yv = orbit.semiMajorAxis * orbit.minorAxisFactor * sinDeg(e);
+    const double anomalyAndPerihelion = degrees(atan2(yv, xv)) + orbit.perihelion;
+    double distance = sqrt(xv * xv + yv * yv);
+
+    const double cosArg = cosDeg(anomalyAndPerihelion), sinArg = sinDeg(anomalyAndPerihelion);
+    double xg = distance * (orbit.cosNode * cosArg - orbit.sinNode * sinArg * orbit.cosInclination);
+    double yg = distance * (orbit.sinNode * cosArg + orbit.cosNode * sinArg * orbit.cosInclination);
+    double zg = distance * sinArg * orbit.sinInclination;
+
+    // The perturbations are corrections to ecliptic longitude and latitude
+    if (object == Moon || object == Jupiter || object == Saturn)
+    {
+        double longitude = degrees(atan2(yg, xg));
+        double latitude = degrees(atan2(zg, sqrt(xg * xg + yg * yg)));
+        const double mj = step.jupiterMeanAnomaly, ms = step.saturnMeanAnomaly;
+        if (object == Moon)
+        {
+            perturbMoon(step, meanAnomaly, orbit.node, orbit.perihelion, longitude, latitude, distance);
+        }
+        else if (object == Jupiter)
+        {
+            longitude += -0.332 * sinDeg(2 * mj - 5 * ms - 67.6) - 0.056 * sinDeg(2 * mj - 2 * ms + 21) +
+                         0.042 * sinDeg(3 * mj - 5 * ms + 21) - 0.036 * sinDeg(mj - 2 * ms);
+        }
+        else
+        {
+            longitude += 0.812 * sinDeg(2 * mj - 5 * ms - 67.6) - 0.229 * cosDeg(2 * mj - 4 * ms - 2) +
+                         0.119 * sinDeg(mj - 2 * ms - 3) + 0.046 * sinDeg(2 * mj - 6 * ms - 69);
+            latitude += -0.020 * cosDeg(2 * mj - 4 * ms - 2) + 0.018 * sinDeg(2 * mj - 6 * ms - 49);
+        }
+        const double cosLatitude = cosDeg(latitude);
+        xg = distance * cosDeg(longitude) * cosLatitude;
+        yg = distance * sinDeg(longitude) * cosLatitude;
+        zg = distance * sinDeg(latitude);
+    }
+    if (object != Moon)
+    {
+        xg += step.sunX;
+        yg += step.sunY;
+    }
+
+    // Ecliptic to equatorial, rotated by the sidereal time into hour angle, then to the observer's horizon;
+    // the vector keeps its length throughout, which atan2 does not mind
+    const double ye = yg * step.cosObliquity - zg * step.sinObliquity;
+    const double ze = yg * step.sinObliquity + zg * step.cosObliquity;
+    const double x = step.cosSiderealTime * xg + step.sinSiderealTime * ye;
+    const double y = step.sinSiderealTime * xg - step.cosSiderealTime * ye;
+    const double xhor = x * step.sinLatitude - ze * step.cosLatitude;
+    const double zhor = x * step.cosLatitude + ze * step.sinLatitude;
+
+    AlmanacData result;
+    double altitude = degrees(atan2(zhor, sqrt(xhor * xhor + y * y)));
+    if (object == Moon)
+    {
+        // The Moon is close enough for the observer's offset from the Earth's centre to matter
+        altitude -= degrees(asin(1.0 / distance)) * cosDeg(altitude);
+    }
+    result.hc = static_cast<float>(altitude);
+    result.zn = static_cast<float>(normalizeDegrees(degrees(atan2(y, xhor)) + 180.0));
+    return result;
+}
+
+// Closes or extends the body's visible intervals with the step's visibility.
+static void trackVisibility(BodyTrack &track, bool wasVisible, bool visible, time_t time)
+{
+    if (!visible)
+    {
+        return;
+    }
+    if (wasVisible && track.intervalCount > 0)
+    {
+        track.intervals[track.intervalCount - 1].end = time;
+        return;
+    }
+    if (track.intervalCount < TIMELINE_MAX_INTERVALS)
+    {
+        track.intervals[track.intervalCount++] = {time, time};
+    }
+}
+
+void computeNightTimeline(NightTimeline &timeline, const GeoLocation &location, time_t sunset, time_t sunrise,
+                          const HorizonMask &mask, uint8_t steps)
+{
+    ScopedLatency timer(LATENCY_TIMELINE);
+
+    steps = constrain(steps, 2, TIMELINE_MAX_STEPS);
+    timeline.start = sunset;
+    timeline.stepSeconds = static_cast<long>((sunrise - sunset) / (steps - 1));
+    timeline.stepCount = steps;
+
+    NightOrbit orbits[MAX_CELESTIAL_BODIES];
+    const double middle = static_cast<double>(sunset + (sunrise - sunset) / 2 - ELEMENTS_EPOCH) / SECS_PER_DAY;
+    bool wasVisible[MAX_CELESTIAL_BODIES] = {};
+    for (uint8_t body = 0; body < MAX_CELESTIAL_BODIES; body++)
+    {
+        beginOrbit(orbits[body], ELEMENTS[body], middle);
+        timeline.bodies[body].object = static_cast<CelestialObject>(body);
+        timeline.bodies[body].intervalCount = 0;
+    }
+
+    StepContext step;
+    step.sinLatitude = sinDeg(location.latitude);
+    step.cosLatitude = cosDeg(location.latitude);
+    for (uint8_t i = 0; i < steps; i++)
+    {
+        const time_t time = timeline.timeAt(i);
+        beginStep(step, time, location.longitude);
+        for (uint8_t body = 0; body < MAX_CELESTIAL_BODIES; body++)
+        {
+            BodyTrack &track = timeline.bodies[body];
+            const AlmanacData position = bodyPosition(step, orbits[body], track.object);
+            track.points[i].altitude = static_cast<int16_t>(lroundf(position.hc * 10.0f));
+            track.points[i].azimuth = static_cast<uint16_t>(lroundf(position.zn * 10.0f) % 3600);
+
+            const bool visible = mask.isVisible(position);
+            trackVisibility(track, wasVisible[body], visible, time);
+            wasVisible[body] = visible;
+        }
+    }
+}
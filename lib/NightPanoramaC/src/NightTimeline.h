@@ -0,0 +1,61 @@
+#ifndef NIGHTTIMELINE_H
+#define NIGHTTIMELINE_H
+
+#include "CelestialInfo.h"
+
+const uint8_t TIMELINE_MAX_STEPS = 49;    // Quarter-hour steps over a 12-hour night, both ends included
+const uint8_t TIMELINE_MAX_INTERVALS = 3; // A body crosses the FOV at most twice a night, plus one spare
+
+// Position of a body at one step, in tenths of a degree.
+struct TrackPoint
+{
+    int16_t altitude;
+    uint16_t azimuth;
+};
+
+// Stretch of the night during which a body is above the horizon mask, which covers the FOV.
+struct VisibleInterval
+{
+    time_t start; // First step at which the body was visible
+    time_t end;   // Last step at which the body was visible
+};
+
+struct BodyTrack
+{
+    CelestialObject object;
+    TrackPoint points[TIMELINE_MAX_STEPS];
+    VisibleInterval intervals[TIMELINE_MAX_INTERVALS];
+    uint8_t intervalCount;
+};
+
+struct NightTimeline
+{
+    time_t start;
+    long stepSeconds;
+    uint8_t stepCount;
+    BodyTrack bodies[MAX_CELESTIAL_BODIES];
+
+    time_t timeAt(uint8_t step) const { return start + static_cast<time_t>(step) * stepSeconds; }
+};
+
+/**
+ * Samples the altitude and azimuth of all bodies at evenly spaced steps from
+ * sunset to sunrise. Uses its own low-precision ephemeris (orbital elements
+ * with the main perturbations, accurate to a few arc minutes for the planets
+ * and a few tenths of a degree for the Moon), so the per-step quantities --
+ * the date, the Sun's position, the sidereal time and the obliquity -- are
+ * computed once per step and shared by all eight bodies. The replay's
+ * ephemeris stage fails when a point strays more than 0.5 degree from
+ * calculateAlmanacData, which getCelestialInfo uses.
+ *
+ * @param timeline Receives the tracks and the visible intervals.
+ * @param location The geographical coordinates where observations are made.
+ * @param sunset The expected time of the next sunset at the given location.
+ * @param sunrise The expected time of the next sunrise at the given location.
+ * @param mask Field of view and horizon profile, e.g. CelestialEngine::horizonMask.
+ * @param steps Number of steps, both ends included; clamped to 2..TIMELINE_MAX_STEPS.
+ */
+void computeNightTimeline(NightTimeline &timeline, const GeoLocation &location, time_t sunset, time_t sunrise,
+                          const HorizonMask &mask, uint8_t steps = TIMELINE_MAX_STEPS);
+
+#endif // NIGHTTIMELINE_H
@@ -31,4 +31,10 @@ struct FieldOfView {
     uint16_t rightBound;
 };
 
+// Define a struct for a body's altitude (hc) and azimuth (zn) in degrees
+struct AlmanacData {
+    float hc;
+    float zn;
+};
+
 #endif // SHAREDSTRUCTS_H
\ No newline at end of file
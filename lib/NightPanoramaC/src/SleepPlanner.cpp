@@ -0,0 +1,43 @@
+#include "SleepPlanner.h"
+
+SleepPlanner::SleepPlanner(unsigned long maxSleepMs, unsigned long awakeMs)
+    : maxSleepMs(maxSleepMs), awakeMs(awakeMs), lastActivity(0), hasActivity(false), total(0), windowStart(0),
+      windowIdle(0)
+{
+}
+
+void SleepPlanner::noteActivity(unsigned long now)
+{
+    lastActivity = now;
+    hasActivity = true;
+}
+
+/**
+ * @param now Current millis().
+ * @param timeUntilNext Milliseconds until the next timer is due, e.g. TimerWheel::timeUntilNext(),
+ *                      ULONG_MAX when none is scheduled.
+ * @return At most maxSleepMs; 0 while a timer is due or a request was answered less than awakeMs ago.
+ */
+unsigned long SleepPlanner::plan(unsigned long now, unsigned long timeUntilNext) const
+{
+    if (hasActivity && now - lastActivity < awakeMs)
+    {
+        return 0;
+    }
+    return timeUntilNext < maxSleepMs ? timeUntilNext : maxSleepMs;
+}
+
+void SleepPlanner::recordIdle(unsigned long idleMs)
+{
+    total += idleMs;
+    windowIdle += idleMs;
+}
+
+uint8_t SleepPlanner::takeIdlePercent(unsigned long now)
+{
+    const unsigned long elapsed = now - windowStart;
+    const unsigned long idle = windowIdle < elapsed ? windowIdle : elapsed;
+    windowStart = now;
+    windowIdle = 0;
+    return elapsed > 0 ? static_cast<uint8_t>(static_cast<uint64_t>(idle) * 100 / elapsed) : 0;
+}
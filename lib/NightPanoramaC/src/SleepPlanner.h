@@ -0,0 +1,44 @@
+#ifndef SLEEPPLANNER_H
+#define SLEEPPLANNER_H
+
+#include <Arduino.h>
+
+/**
+ * Decides how long loop() may sleep before the next scheduled event, and keeps
+ * count of the time it then spent idle in delay(). Whether the SDK really slept
+ * during that time is not known here, so that is all the count claims. Sleep
+ * is handed out in slices of at most maxSleepMs, so a request that arrives
+ * meanwhile waits at most one slice before the loop looks again. For awakeMs
+ * after a request nothing is handed out at all, so a page and the requests
+ * that follow it are answered at full speed.
+ */
+class SleepPlanner
+{
+public:
+    SleepPlanner(unsigned long maxSleepMs, unsigned long awakeMs);
+
+    // Records a request or other work at now that more is likely to follow.
+    void noteActivity(unsigned long now);
+
+    // Milliseconds to sleep at now, given the time until the next scheduled event; 0 to keep running.
+    unsigned long plan(unsigned long now, unsigned long timeUntilNext) const;
+
+    void recordIdle(unsigned long idleMs);
+
+    uint64_t totalIdleMs() const { return total; }
+    unsigned long maxLatencyMs() const { return maxSleepMs; }
+
+    // Percent of the time since the previous call that was spent idle; starts a new window.
+    uint8_t takeIdlePercent(unsigned long now);
+
+private:
+    unsigned long maxSleepMs;
+    unsigned long awakeMs;
+    unsigned long lastActivity;
+    bool hasActivity;
+    uint64_t total;
+    unsigned long windowStart;
+    unsigned long windowIdle;
+};
+
+#endif // SLEEPPLANNER_H
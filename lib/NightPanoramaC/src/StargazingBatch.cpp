@@ -0,0 +1,147 @@
+#ifdef NIGHTPANORAMAC_HOST
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "StargazingBatch.h"
+
+// Locations a worker takes from its own range at a time; small enough to balance, large enough to keep locking rare.
+const size_t BATCH_GRAIN = 8;
+
+// Range of locations still to be computed by one worker. The owner takes from
+// the front, thieves split off the back half, rounded up so the last one goes
+// too. Both bounds change only under the mutex; they are atomic so thieves can
+// compare sizes without locking.
+struct BatchRange
+{
+    std::mutex mutex;
+    std::atomic<size_t> next;
+    std::atomic<size_t> end;
+
+    size_t size() const
+    {
+        size_t first = next.load(std::memory_order_relaxed);
+        size_t last = end.load(std::memory_order_relaxed);
+        return last > first ? last - first : 0;
+    }
+};
+
+static bool takeOwnWork(BatchRange &range, size_t &begin, size_t &end)
+{
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.next >= range.end)
+    {
+        return false;
+    }
+    begin = range.next;
+    end = std::min<size_t>(range.end, begin + BATCH_GRAIN);
+    range.next = end;
+    return true;
+}
+
+static bool stealWork(std::vector<std::unique_ptr<BatchRange>> &ranges, BatchRange &own)
+{
+    // Pick the victim with the most work left; sizes are read without locking, so re-check under the lock
+    BatchRange *victim = nullptr;
+    size_t victimSize = 0;
+    for (auto &range : ranges)
+    {
+        size_t size = range->size();
+        if (range.get() != &own && size > victimSize)
+        {
+            victim = range.get();
+            victimSize = size;
+        }
+    }
+    if (victim == nullptr)
+    {
+        return false;
+    }
+
+    size_t begin, end;
+    {
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (victim->next >= victim->end)
+        {
+            return true; // Someone else got there first; look again
+        }
+        end = victim->end;
+        begin = victim->next + (victim->end - victim->next) / 2;
+        victim->end = begin;
+    }
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.next = begin;
+    own.end = end;
+    return true;
+}
+
+static void computeRange(CelestialEngine &engine, const GeoLocation *locations, const FieldOfView *fovs,
+                         StargazingInfo *results, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        StargazingInfo &result = results[i];
+        engine.begin(result.celestial, locations[i]);
+        for (uint8_t body = 0; body < MAX_CELESTIAL_BODIES; ++body)
+        {
+            engine.computeBody(result.celestial, body, result.weather.nextSunset, result.weather.nextSunrise, fovs[i]);
+        }
+    }
+}
+
+void getStargazingInfoBatch(const GeoLocation *locations, const FieldOfView *fovs, StargazingInfo *results,
+                            size_t count, unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, (count + BATCH_GRAIN - 1) / BATCH_GRAIN));
+    if (threadCount == 0)
+    {
+        return;
+    }
+
+    // Start with an even split; stealing evens out whatever imbalance remains
+    std::vector<std::unique_ptr<BatchRange>> ranges;
+    for (unsigned t = 0; t < threadCount; ++t)
+    {
+        ranges.emplace_back(new BatchRange);
+        ranges[t]->next = count * t / threadCount;
+        ranges[t]->end = count * (t + 1) / threadCount;
+    }
+
+    auto worker = [&](unsigned t)
+    {
+        // Engines are large (calculator, cache), so they live on the heap, one per thread
+        std::unique_ptr<CelestialEngine> engine(new CelestialEngine);
+        BatchRange &own = *ranges[t];
+        for (;;)
+        {
+            size_t begin, end;
+            if (takeOwnWork(own, begin, end))
+            {
+                computeRange(*engine, locations, fovs, results, begin, end);
+            }
+            else if (!stealWork(ranges, own))
+            {
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; ++t)
+    {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+#endif // NIGHTPANORAMAC_HOST
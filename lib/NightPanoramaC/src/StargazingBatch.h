@@ -0,0 +1,29 @@
+#ifndef STARGAZINGBATCH_H
+#define STARGAZINGBATCH_H
+
+// Host-only: batch evaluation needs threads, which the device does not have.
+#ifdef NIGHTPANORAMAC_HOST
+
+#include <stddef.h>
+#include "StargazingInfo.h"
+
+/**
+ * Computes the celestial part of StargazingInfo for many locations at once, e.g.
+ * to precompute the nights of a fleet of devices on a server. The locations are
+ * split into ranges over a pool of threads; a thread that runs out of work steals
+ * half of the largest remaining range of another thread, so uneven per-location
+ * cost does not leave cores idle. Each thread uses its own CelestialEngine.
+ *
+ * @param locations The observers' locations, count entries.
+ * @param fovs The observers' fields of view, count entries.
+ * @param results Input and output, count entries: the sunset and sunrise in each
+ *                results[i].weather are read, results[i].celestial is written.
+ * @param count Number of locations.
+ * @param threadCount Number of worker threads; 0 uses one per hardware thread.
+ */
+void getStargazingInfoBatch(const GeoLocation *locations, const FieldOfView *fovs, StargazingInfo *results,
+                            size_t count, unsigned threadCount = 0);
+
+#endif // NIGHTPANORAMAC_HOST
+
+#endif // STARGAZINGBATCH_H
@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <strings.h>
+#include <ESP8266WiFi.h>
+#include "Latency.h"
+#include "StargazingFetcher.h"
+
+// Constants
+const unsigned long RESOLVE_TIMEOUT_MS = 1000;   // Upper bound of the DNS lookup; hostByName's own default is 10 s
+const unsigned long CONNECT_TIMEOUT_MS = 2000;   // Upper bound of the TCP connect
+const unsigned long RESPONSE_TIMEOUT_MS = 10000; // Give up when the server stays silent this long
+
+StargazingFetcher::StargazingFetcher(CelestialEngine &engine)
+    : engine(engine), location{}, fov{}, state(FetchState::Idle), apiHost(nullptr), apiAddress(), pending{}, info{}, nextBody(0),
+      seriesLocation{}, seriesMillis(0), seriesUtcOffset(0), seriesNight{}, lineLength(0), statusCode(0), remainingBody(-1),
+      lastActivity(0)
+{
+}
+
+void StargazingFetcher::begin(const GeoLocation &newLocation, const FieldOfView &newFov)
+{
+    client.stop();
+    if (newLocation.latitude != seriesLocation.latitude || newLocation.longitude != seriesLocation.longitude)
+    {
+        series.clear();
+    }
+    location = newLocation;
+    fov = newFov;
+    parser.reset();
+    pending = StargazingInfo{};
+    state = FetchState::Resolve;
+}
+
+/**
+ * Performs the next step of the fetch. Apart from the resolve and connect steps,
+ * bounded by RESOLVE_TIMEOUT_MS and CONNECT_TIMEOUT_MS and run in separate calls,
+ * no step waits for the network: the receive
+ * steps only consume bytes that have already arrived, at most CHUNK_SIZE per call,
+ * and the compute step handles a single celestial body. When the ephemeris
+ * cache already holds the night, the compute steps are skipped.
+ *
+ * @return true if this call completed a fetch; the new data is then in result().
+ */
+bool StargazingFetcher::update()
+{
+    const FetchState previous = state;
+    switch (state)
+    {
+    case FetchState::Resolve:
+        stepResolve();
+        break;
+    case FetchState::Connect:
+        stepConnect();
+        break;
+    case FetchState::SendRequest:
+        stepSendRequest();
+        break;
+    case FetchState::ReceiveHeaders:
+        stepReceiveHeaders();
+        break;
+    case FetchState::ReceiveBody:
+        stepReceiveBody();
+        break;
+    case FetchState::Compute:
+        stepCompute();
+        break;
+    default:
+        break;
+    }
+    return previous != FetchState::Done && state == FetchState::Done;
+}
+
+void StargazingFetcher::fail(const char *reason)
+{
+    Serial.print("Stargazing fetch failed: ");
+    Serial.println(reason);
+    client.stop();
+    state = FetchState::Failed;
+}
+
+// Looks up the API host unless its address is already known. WiFiClient::connect(host, port)
+// would resolve with hostByName's default timeout, which the client timeout does not cover.
+void StargazingFetcher::stepResolve()
+{
+    if (apiHost == weatherApiHost() && apiAddress.isSet())
+    {
+        state = FetchState::Connect;
+        return;
+    }
+
+    ScopedLatency timer(LATENCY_RESOLVE);
+    apiHost = nullptr;
+    if (WiFi.hostByName(weatherApiHost(), apiAddress, RESOLVE_TIMEOUT_MS) != 1 || !apiAddress.isSet())
+    {
+        fail("resolve");
+        return;
+    }
+    apiHost = weatherApiHost();
+    state = FetchState::Connect;
+}
+
+void StargazingFetcher::stepConnect()
+{
+    ScopedLatency timer(LATENCY_CONNECT);
+    client.setTimeout(CONNECT_TIMEOUT_MS);
+    if (!client.connect(apiAddress, weatherApiPort()))
+    {
+        // The address may be stale; look it up again next time
+        apiHost = nullptr;
+        fail("connect");
+        return;
+    }
+    state = FetchState::SendRequest;
+}
+
+void StargazingFetcher::stepSendRequest()
+{
+    ScopedLatency timer(LATENCY_HTTP_GET);
+
+    // HTTP/1.0 keeps the body free of chunk markers so it can be parsed as it arrives
+    char request[WEATHER_QUERY_PATH_SIZE + 96];
+    int length = snprintf(request, sizeof(request), "GET ");
+    length += formatQueryPath(request + length, sizeof(request) - length);
+    length += snprintf(request + length, sizeof(request) - length,
+                       " HTTP/1.0\r\nHost: %s\r\nConnection: close\r\n\r\n", weatherApiHost());
+    if (length >= static_cast<int>(sizeof(request)) ||
+        client.write(reinterpret_cast<const uint8_t *>(request), length) != static_cast<size_t>(length))
+    {
+        fail("send request");
+        return;
+    }
+
+    lineLength = 0;
+    statusCode = 0;
+    remainingBody = -1;
+    lastActivity = millis();
+    state = FetchState::ReceiveHeaders;
+}
+
+// Handles one complete header line; returns false when the headers are over.
+bool StargazingFetcher::onHeaderLine()
+{
+    line[lineLength] = '\0';
+    lineLength = 0;
+
+    if (statusCode == 0)
+    {
+        if (sscanf(line, "HTTP/%*d.%*d %d", &statusCode) != 1)
+            statusCode = -1;
+        return true;
+    }
+    if (line[0] == '\0')
+        return false;
+    if (strncasecmp(line, "Content-Length:", 15) == 0)
+        remainingBody = atol(line + 15);
+    return true;
+}
+
+void StargazingFetcher::stepReceiveHeaders()
+{
+    int available = client.available();
+    if (available <= 0)
+    {
+        if (!client.connected())
+            fail("connection closed before headers");
+        else if (millis() - lastActivity > RESPONSE_TIMEOUT_MS)
+            fail("response timeout");
+        return;
+    }
+
+    ScopedLatency timer(LATENCY_HEADERS);
+    lastActivity = millis();
+    for (size_t n = 0; n < CHUNK_SIZE && available-- > 0; ++n)
+    {
+        int c = client.read();
+        if (c < 0)
+            break;
+        if (c == '\r')
+            continue;
+        if (c != '\n')
+        {
+            if (lineLength < LINE_SIZE - 1)
+                line[lineLength++] = static_cast<char>(c);
+            continue;
+        }
+        if (!onHeaderLine())
+        {
+            if (statusCode != 200)
+            {
+                Serial.print("HTTP Response Code: ");
+                Serial.println(statusCode);
+                fail("HTTP status");
+                return;
+            }
+            state = FetchState::ReceiveBody;
+            return;
+        }
+    }
+}
+
+void StargazingFetcher::stepReceiveBody()
+{
+    int available = client.available();
+    if (available > 0)
+    {
+        char chunk[CHUNK_SIZE];
+        size_t wanted = available < static_cast<int>(CHUNK_SIZE) ? available : CHUNK_SIZE;
+        if (remainingBody >= 0 && static_cast<long>(wanted) > remainingBody)
+            wanted = remainingBody;
+
+        int length;
+        {
+            ScopedLatency timer(LATENCY_BODY_READ);
+            length = client.read(reinterpret_cast<uint8_t *>(chunk), wanted);
+        }
+        if (length > 0)
+        {
+            lastActivity = millis();
+            if (remainingBody >= 0)
+                remainingBody -= length;
+            bool isValid;
+            {
+                ScopedLatency timer(LATENCY_PARSE);
+                isValid = parser.feed(chunk, length);
+            }
+            if (!isValid)
+            {
+                fail("malformed weather response");
+                return;
+            }
+        }
+    }
+    else if (client.connected() && millis() - lastActivity <= RESPONSE_TIMEOUT_MS)
+    {
+        return;
+    }
+
+    if (!parser.isComplete() && remainingBody != 0 && client.connected())
+    {
+        if (millis() - lastActivity > RESPONSE_TIMEOUT_MS)
+            fail("response timeout");
+        return;
+    }
+
+    client.stop();
+    if (!parser.finish(pending.weather, series))
+    {
+        fail("incomplete weather response");
+        return;
+    }
+    seriesLocation = location;
+    seriesMillis = millis();
+    seriesUtcOffset = parser.utcOffset();
+    seriesNight = pending.weather;
+    if (engine.findCached(pending.celestial, location, pending.weather.nextSunset, fov))
+    {
+        info = pending;
+        state = FetchState::Done;
+        return;
+    }
+    engine.begin(pending.celestial, location);
+    nextBody = 0;
+    state = FetchState::Compute;
+}
+
+/**
+ * Writes the path of the forecast request. While the night the retained series
+ * was summarized for is still ahead, only that night's hours are requested: the
+ * full hours from its sunset up to the last one before its sunrise, which are
+ * the only hours the summary counts. Without a series, or once that night has
+ * begun, the sunset of the night the response will select is not known yet, so
+ * FORECAST_HOURS from the current hour are requested, daytime hours included.
+ */
+int StargazingFetcher::formatQueryPath(char *buffer, size_t size) const
+{
+    if (series.isEmpty() || currentTime() >= seriesNight.nextSunset)
+    {
+        return formatWeatherQueryPath(buffer, size, location, FORECAST_HOURS);
+    }
+    const time_t sunset = seriesNight.nextSunset + seriesUtcOffset;
+    const time_t sunrise = seriesNight.nextSunrise + seriesUtcOffset;
+    const time_t firstHour = (sunset + SECS_PER_HOUR - 1) / SECS_PER_HOUR * SECS_PER_HOUR;
+    const time_t lastHour = (sunrise - 1) / SECS_PER_HOUR * SECS_PER_HOUR;
+    return formatWeatherQueryPath(buffer, size, location, firstHour, lastHour > firstHour ? lastHour : firstHour);
+}
+
+/**
+ * Wall-clock time as far as the device knows it: the API's current time in
+ * the last response, advanced by millis() since it arrived. The board has no
+ * clock of its own, so this is what sky events are scheduled against.
+ *
+ * @return Unix time, or 0 before a response has been received for the current location.
+ */
+time_t StargazingFetcher::currentTime() const
+{
+    if (series.isEmpty())
+    {
+        return 0;
+    }
+    return series.getAsOf() + static_cast<time_t>((millis() - seriesMillis) / 1000);
+}
+
+void StargazingFetcher::stepCompute()
+{
+    engine.computeBody(pending.celestial, nextBody, pending.weather.nextSunset, pending.weather.nextSunrise, fov);
+    if (++nextBody < MAX_CELESTIAL_BODIES)
+        return;
+
+    engine.storeCached(pending.celestial, location, pending.weather.nextSunset, fov);
+    info = pending;
+    state = FetchState::Done;
+}
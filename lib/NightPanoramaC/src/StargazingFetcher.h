@@ -0,0 +1,90 @@
+#ifndef STARGAZINGFETCHER_H
+#define STARGAZINGFETCHER_H
+
+#include <IPAddress.h>
+#include <WiFiClient.h>
+#include "StargazingInfo.h"
+#include "WeatherParser.h"
+
+enum class FetchState : uint8_t
+{
+    Idle,
+    Resolve,
+    Connect,
+    SendRequest,
+    ReceiveHeaders,
+    ReceiveBody,
+    Compute,
+    Done,
+    Failed
+};
+
+/**
+ * Incremental version of `getStargazingInfo`.
+ * The fetch is split into resolve, connect, send, receive/parse and per-body compute
+ * steps; each call to `update` performs one bounded step, so a caller such as
+ * the firmware's loop() keeps serving other work while a fetch is in flight.
+ * The previous result stays available until a new one is complete.
+ * The hourly forecast is kept between fetches at the same location, so a
+ * refresh during the day only requests the hours of the coming night.
+ */
+class StargazingFetcher
+{
+public:
+    explicit StargazingFetcher(CelestialEngine &engine = defaultCelestialEngine());
+
+    // Starts a fetch, abandoning any fetch still in progress.
+    void begin(const GeoLocation &location, const FieldOfView &fov);
+
+    // Advances the fetch by one step; returns true when a new result has just completed.
+    bool update();
+
+    bool isBusy() const { return state != FetchState::Idle && state != FetchState::Done && state != FetchState::Failed; }
+    FetchState getState() const { return state; }
+    const StargazingInfo &result() const { return info; }
+    time_t currentTime() const;
+
+private:
+    static const uint8_t LINE_SIZE = 128;
+    static const size_t CHUNK_SIZE = 256;
+
+    void fail(const char *reason);
+    void stepResolve();
+    void stepConnect();
+    void stepSendRequest();
+    void stepReceiveHeaders();
+    void stepReceiveBody();
+    void stepCompute();
+    bool onHeaderLine();
+    int formatQueryPath(char *buffer, size_t size) const;
+
+    CelestialEngine &engine;
+    WiFiClient client;
+    WeatherParser parser;
+    GeoLocation location;
+    FieldOfView fov;
+    FetchState state;
+
+    // Address of apiHost, looked up once and kept until a connect to it fails
+    const char *apiHost;
+    IPAddress apiAddress;
+
+    StargazingInfo pending;
+    StargazingInfo info;
+    uint8_t nextBody;
+
+    // Hourly forecast retained from earlier fetches at seriesLocation, and the night it was summarized for
+    ForecastSeries series;
+    GeoLocation seriesLocation;
+    unsigned long seriesMillis;
+    long seriesUtcOffset;
+    WeatherInfo seriesNight;
+
+    char line[LINE_SIZE];
+    uint8_t lineLength;
+    int statusCode;
+    long remainingBody;
+    unsigned long lastActivity;
+};
+
+#endif // STARGAZINGFETCHER_H
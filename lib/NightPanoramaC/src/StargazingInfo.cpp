@@ -7,11 +7,14 @@
  * It then calls `getCelestialInfo` to get information about celestial bodies that are
  * visible between the times of the next sunset and sunrise, within the provided field of view.
  *
+ * The celestial part is computed by the given engine; callers on different threads pass different engines.
+ *
+ * @param engine The engine performing the celestial computation.
  * @param location The geographical location for which stargazing info is requested.
  * @param fov The field of view from the observer's location.
  * @return StargazingInfo A struct containing weather conditions and visible celestial bodies.
  */
-StargazingInfo getStargazingInfo(const GeoLocation &location, const FieldOfView &fov)
+StargazingInfo getStargazingInfo(CelestialEngine &engine, const GeoLocation &location, const FieldOfView &fov)
 {
     StargazingInfo stargazingInfo;
 
@@ -20,7 +23,13 @@ StargazingInfo getStargazingInfo(const GeoLocation &location, const FieldOfView
     stargazingInfo.weather = weather;
 
     // Use sunset and sunrise times from the weather info to get celestial information
-    CelestialInfo celestial = getCelestialInfo(location, weather.nextSunset, weather.nextSunrise, fov);
+    CelestialInfo celestial = engine.compute(location, weather.nextSunset, weather.nextSunrise, fov);
     stargazingInfo.celestial = celestial;
     return stargazingInfo;
 }
+
+// Same as above, using the default engine.
+StargazingInfo getStargazingInfo(const GeoLocation &location, const FieldOfView &fov)
+{
+    return getStargazingInfo(defaultCelestialEngine(), location, fov);
+}
@@ -10,5 +10,6 @@ struct StargazingInfo {
 };
 
 StargazingInfo getStargazingInfo(const GeoLocation& location, const FieldOfView& fov);
+StargazingInfo getStargazingInfo(CelestialEngine& engine, const GeoLocation& location, const FieldOfView& fov);
 
 #endif // STARGAZINGINFO_H
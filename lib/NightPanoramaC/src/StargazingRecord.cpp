@@ -0,0 +1,211 @@
+#include <string.h>
+#include "StargazingRecord.h"
+#include "Utils.h"
+
+const uint8_t RECORD_MAGIC[4] = {'N', 'P', 'S', 'R'};
+
+// CRC-32 (IEEE 802.3, reflected), bit by bit; records are small and written rarely.
+static uint32_t crc32(const uint8_t *data, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Sequential little-endian writer; the caller guarantees the buffer is large enough.
+struct RecordWriter
+{
+    uint8_t *cursor;
+
+    void put(uint64_t value, uint8_t bytes)
+    {
+        for (uint8_t i = 0; i < bytes; i++)
+        {
+            *cursor++ = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void putFloat(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        put(bits, 4);
+    }
+};
+
+// Sequential little-endian reader; the caller checks the length beforehand.
+struct RecordReader
+{
+    const uint8_t *cursor;
+
+    uint64_t get(uint8_t bytes)
+    {
+        uint64_t value = 0;
+        for (uint8_t i = 0; i < bytes; i++)
+        {
+            value |= static_cast<uint64_t>(*cursor++) << (8 * i);
+        }
+        return value;
+    }
+
+    float getFloat()
+    {
+        uint32_t bits = static_cast<uint32_t>(get(4));
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+/**
+ * Serializes a snapshot into the versioned, checksummed record format.
+ *
+ * @param snapshot The data to store.
+ * @param buffer Destination of at least STARGAZING_RECORD_SIZE bytes.
+ * @param size Size of buffer.
+ * @return The record length, or 0 if buffer is too small.
+ */
+size_t encodeStargazingRecord(const StargazingSnapshot &snapshot, uint8_t *buffer, size_t size)
+{
+    if (size < STARGAZING_RECORD_SIZE)
+    {
+        return 0;
+    }
+
+    RecordWriter writer = {buffer + STARGAZING_RECORD_HEADER_SIZE};
+    writer.putFloat(snapshot.location.latitude);
+    writer.putFloat(snapshot.location.longitude);
+    writer.put(snapshot.fov.leftBound, 2);
+    writer.put(snapshot.fov.rightBound, 2);
+
+    const HorizonProfile &horizon = snapshot.horizon;
+    writer.put(horizon.sectorCount, 1);
+    for (uint8_t i = 0; i < HORIZON_MAX_SECTORS; i++)
+    {
+        const bool isUsed = i < horizon.sectorCount;
+        writer.put(isUsed ? horizon.sectors[i].from : 0, 2);
+        writer.put(isUsed ? horizon.sectors[i].to : 0, 2);
+        writer.put(isUsed ? horizon.sectors[i].minAltitude : 0, 1);
+    }
+
+    const WeatherInfo &weather = snapshot.info.weather;
+    writer.put(weather.isDew != 0, 1);
+    writer.put(weather.rainAmount, 1);
+    writer.put(weather.cloudCover, 1);
+    writer.put(weather.maxCloudCover, 1);
+    writer.put(weather.nightHours, 1);
+    writer.put(weather.clearHours, 1);
+    writer.put(static_cast<int64_t>(weather.nextSunset), 8);
+    writer.put(static_cast<int64_t>(weather.nextSunrise), 8);
+
+    // Unused body slots are written too, so every record has the same size
+    const CelestialInfo &celestial = snapshot.info.celestial;
+    writer.put(celestial.bodyCount, 1);
+    for (uint8_t i = 0; i < MAX_CELESTIAL_BODIES; i++)
+    {
+        const CelestialBodyInfo &body = celestial.bodies[i];
+        const bool isUsed = i < celestial.bodyCount;
+        writer.put(isUsed ? body.object : Undefined, 1);
+        writer.put(isUsed ? static_cast<int64_t>(body.riseAndSet.riseTime) : 0, 8);
+        writer.put(isUsed ? static_cast<int64_t>(body.riseAndSet.setTime) : 0, 8);
+        writer.putFloat(isUsed ? body.positionCulmination.hc : 0);
+        writer.putFloat(isUsed ? body.positionCulmination.zn : 0);
+        writer.put(isUsed && body.isVisible, 1);
+    }
+
+    const uint8_t *payload = buffer + STARGAZING_RECORD_HEADER_SIZE;
+    RecordWriter header = {buffer};
+    memcpy(header.cursor, RECORD_MAGIC, sizeof(RECORD_MAGIC));
+    header.cursor += sizeof(RECORD_MAGIC);
+    header.put(STARGAZING_RECORD_VERSION, 1);
+    header.put(STARGAZING_RECORD_PAYLOAD_SIZE, 2);
+    header.put(crc32(payload, STARGAZING_RECORD_PAYLOAD_SIZE), 4);
+    return STARGAZING_RECORD_SIZE;
+}
+
+/**
+ * Restores a snapshot from a record written by encodeStargazingRecord.
+ *
+ * @param buffer The record.
+ * @param length Number of bytes in buffer.
+ * @param snapshot Receives the data; left untouched when false is returned.
+ * @return false if the record is truncated, corrupted or of another version.
+ */
+bool decodeStargazingRecord(const uint8_t *buffer, size_t length, StargazingSnapshot &snapshot)
+{
+    if (length < STARGAZING_RECORD_HEADER_SIZE || memcmp(buffer, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0)
+    {
+        return false;
+    }
+
+    RecordReader header = {buffer + sizeof(RECORD_MAGIC)};
+    const uint8_t version = static_cast<uint8_t>(header.get(1));
+    const size_t payloadSize = static_cast<size_t>(header.get(2));
+    const uint32_t crc = static_cast<uint32_t>(header.get(4));
+    const uint8_t *payload = buffer + STARGAZING_RECORD_HEADER_SIZE;
+    if (version != STARGAZING_RECORD_VERSION || payloadSize != STARGAZING_RECORD_PAYLOAD_SIZE ||
+        length < STARGAZING_RECORD_HEADER_SIZE + payloadSize || crc32(payload, payloadSize) != crc)
+    {
+        return false;
+    }
+
+    StargazingSnapshot result = {};
+    RecordReader reader = {payload};
+    result.location.latitude = reader.getFloat();
+    result.location.longitude = reader.getFloat();
+    result.fov.leftBound = static_cast<uint16_t>(reader.get(2));
+    result.fov.rightBound = static_cast<uint16_t>(reader.get(2));
+
+    HorizonProfile &horizon = result.horizon;
+    horizon.sectorCount = static_cast<uint8_t>(reader.get(1));
+    if (horizon.sectorCount > HORIZON_MAX_SECTORS)
+    {
+        return false;
+    }
+    for (HorizonSector &sector : horizon.sectors)
+    {
+        sector.from = static_cast<uint16_t>(reader.get(2));
+        sector.to = static_cast<uint16_t>(reader.get(2));
+        sector.minAltitude = static_cast<uint8_t>(reader.get(1));
+    }
+
+    WeatherInfo &weather = result.info.weather;
+    weather.isDew = reader.get(1) != 0;
+    weather.rainAmount = static_cast<uint8_t>(reader.get(1));
+    weather.cloudCover = static_cast<uint8_t>(reader.get(1));
+    weather.maxCloudCover = static_cast<uint8_t>(reader.get(1));
+    weather.nightHours = static_cast<uint8_t>(reader.get(1));
+    weather.clearHours = static_cast<uint8_t>(reader.get(1));
+    weather.nextSunset = static_cast<time_t>(static_cast<int64_t>(reader.get(8)));
+    weather.nextSunrise = static_cast<time_t>(static_cast<int64_t>(reader.get(8)));
+
+    CelestialInfo &celestial = result.info.celestial;
+    celestial.bodyCount = static_cast<uint8_t>(reader.get(1));
+    if (celestial.bodyCount > MAX_CELESTIAL_BODIES)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < MAX_CELESTIAL_BODIES; i++)
+    {
+        CelestialBodyInfo &body = celestial.bodies[i];
+        const uint8_t object = static_cast<uint8_t>(reader.get(1));
+        body.object = object < Undefined ? static_cast<CelestialObject>(object) : Undefined;
+        strncpy(body.name, celestialObjectName(body.object), sizeof(body.name) - 1);
+        body.name[sizeof(body.name) - 1] = '\0';
+        body.riseAndSet.riseTime = static_cast<time_t>(static_cast<int64_t>(reader.get(8)));
+        body.riseAndSet.setTime = static_cast<time_t>(static_cast<int64_t>(reader.get(8)));
+        body.positionCulmination.hc = reader.getFloat();
+        body.positionCulmination.zn = reader.getFloat();
+        body.isVisible = reader.get(1) != 0;
+    }
+
+    snapshot = result;
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef STARGAZINGRECORD_H
+#define STARGAZINGRECORD_H
+
+#include "StargazingInfo.h"
+
+// Everything needed to show the last result again after a reboot.
+struct StargazingSnapshot
+{
+    GeoLocation location;
+    FieldOfView fov;
+    HorizonProfile horizon;
+    StargazingInfo info;
+};
+
+/*
+ * Binary record of a StargazingSnapshot, little-endian, independent of struct layout:
+ *
+ *   header   magic "NPSR" (4), version (1), payload length (2), CRC-32 of the payload (4)
+ *   payload  latitude, longitude (float, 4 each), FOV bounds (2 each),
+ *            horizon sector count (1), then per sector: from, to (2 each), altitude (1),
+ *            dew (1), rain (1), cloud cover (1), peak cloud cover (1), night hours (1),
+ *            clear hours (1), next sunset, next sunrise (8 each),
+ *            body count (1), then per body: object (1), rise, set (8 each),
+ *            altitude, azimuth (float, 4 each), visible (1)
+ *
+ * Body names are not stored; they follow from the object. All HORIZON_MAX_SECTORS
+ * sector slots are written, used or not.
+ */
+const uint8_t STARGAZING_RECORD_VERSION = 3;
+const size_t STARGAZING_RECORD_HEADER_SIZE = 11;
+const size_t STARGAZING_RECORD_SECTOR_SIZE = 5;
+const size_t STARGAZING_RECORD_BODY_SIZE = 26;
+const size_t STARGAZING_RECORD_PAYLOAD_SIZE = 12 + 1 + HORIZON_MAX_SECTORS * STARGAZING_RECORD_SECTOR_SIZE + 22 + 1 +
+                                              MAX_CELESTIAL_BODIES * STARGAZING_RECORD_BODY_SIZE;
+const size_t STARGAZING_RECORD_SIZE = STARGAZING_RECORD_HEADER_SIZE + STARGAZING_RECORD_PAYLOAD_SIZE;
+
+size_t encodeStargazingRecord(const StargazingSnapshot &snapshot, uint8_t *buffer, size_t size);
+bool decodeStargazingRecord(const uint8_t *buffer, size_t length, StargazingSnapshot &snapshot);
+
+#endif // STARGAZINGRECORD_H
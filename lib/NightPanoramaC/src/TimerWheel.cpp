@@ -0,0 +1,149 @@
+#include "TimerWheel.h"
+
+// Whether due has been reached at now; millis() wraps, so compare the difference.
+static bool isDue(unsigned long due, unsigned long now)
+{
+    return static_cast<long>(now - due) >= 0;
+}
+
+TimerWheel::TimerWheel() : slots{}, ready(nullptr), lastTick(0)
+{
+}
+
+void TimerWheel::link(TimerTask &task, TimerTask **list)
+{
+    task.list = list;
+    task.prev = nullptr;
+    task.next = *list;
+    if (task.next != nullptr)
+    {
+        task.next->prev = &task;
+    }
+    *list = &task;
+}
+
+void TimerWheel::unlink(TimerTask &task)
+{
+    if (task.prev != nullptr)
+    {
+        task.prev->next = task.next;
+    }
+    else
+    {
+        *task.list = task.next;
+    }
+    if (task.next != nullptr)
+    {
+        task.next->prev = task.prev;
+    }
+    task.list = nullptr;
+    task.next = nullptr;
+    task.prev = nullptr;
+}
+
+/**
+ * Schedules a task, replacing its previous due time if it was already scheduled.
+ * A task rescheduled from its own callback runs on a later call of run(), even with a delay of 0.
+ *
+ * @param task The task; must stay alive while scheduled.
+ * @param now Current millis().
+ * @param delayMs How long from now the task is due; at most LONG_MAX.
+ */
+void TimerWheel::schedule(TimerTask &task, unsigned long now, unsigned long delayMs)
+{
+    cancel(task);
+    task.due = now + delayMs;
+    link(task, &slots[(task.due / TICK_MS) % SLOTS]);
+}
+
+void TimerWheel::cancel(TimerTask &task)
+{
+    if (task.isScheduled())
+    {
+        unlink(task);
+    }
+}
+
+/**
+ * Runs the due tasks. Only the slots of the ticks since the previous call are
+ * looked at, each at most once, so a call costs O(ticks passed + tasks in
+ * those slots) however many tasks are scheduled further ahead.
+ *
+ * @param now Current millis().
+ * @return The number of tasks that ran.
+ */
+uint8_t TimerWheel::run(unsigned long now)
+{
+    const unsigned long nowTick = now / TICK_MS;
+    const unsigned long passed = nowTick - lastTick;
+    const uint8_t visits = passed >= SLOTS ? SLOTS : static_cast<uint8_t>(passed + 1);
+    lastTick = nowTick;
+
+    // Move the due tasks out of the wheel first, so callbacks can schedule and cancel freely
+    for (uint8_t i = 0; i < visits; i++)
+    {
+        TimerTask *task = slots[(nowTick - i) % SLOTS];
+        while (task != nullptr)
+        {
+            TimerTask *next = task->next;
+            if (isDue(task->due, now))
+            {
+                unlink(*task);
+                TimerTask *before = nullptr;
+                TimerTask *after = ready;
+                while (after != nullptr && isDue(after->due, task->due))
+                {
+                    before = after;
+                    after = after->next;
+                }
+                task->list = &ready;
+                task->prev = before;
+                task->next = after;
+                if (before != nullptr)
+                {
+                    before->next = task;
+                }
+                else
+                {
+                    ready = task;
+                }
+                if (after != nullptr)
+                {
+                    after->prev = task;
+                }
+            }
+            task = next;
+        }
+    }
+
+    uint8_t count = 0;
+    while (ready != nullptr)
+    {
+        TimerTask &task = *ready;
+        unlink(task);
+        task.callback(task);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Time the caller may sleep before the next call of run() has work to do.
+ * Walks all slots; meant for a handful of tasks, once per idle loop pass.
+ */
+unsigned long TimerWheel::timeUntilNext(unsigned long now) const
+{
+    unsigned long earliest = ULONG_MAX;
+    for (TimerTask *const slot : slots)
+    {
+        for (const TimerTask *task = slot; task != nullptr; task = task->next)
+        {
+            const unsigned long wait = isDue(task->due, now) ? 0 : task->due - now;
+            if (wait < earliest)
+            {
+                earliest = wait;
+            }
+        }
+    }
+    return earliest;
+}
@@ -0,0 +1,73 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <Arduino.h>
+#include <limits.h>
+
+class TimerWheel;
+
+/**
+ * A piece of work due at a point in millis() time. Tasks are owned by the
+ * caller and linked into the wheel while scheduled, so scheduling never
+ * allocates. A task runs once per schedule; periodic work reschedules itself
+ * from its callback.
+ */
+class TimerTask
+{
+public:
+    typedef void (*Callback)(TimerTask &task);
+
+    explicit TimerTask(Callback callback, uint8_t tag = 0)
+        : tag(tag), callback(callback), due(0), next(nullptr), prev(nullptr), list(nullptr)
+    {
+    }
+
+    bool isScheduled() const { return list != nullptr; }
+    unsigned long dueAt() const { return due; }
+
+    uint8_t tag; // Free for the callback, e.g. which body an event belongs to
+
+private:
+    friend class TimerWheel;
+
+    Callback callback;
+    unsigned long due;
+    TimerTask *next;
+    TimerTask *prev;
+    TimerTask **list; // Head of the slot or ready list the task is in; nullptr while not scheduled
+};
+
+/**
+ * Hashed timer wheel over millis(): a task goes into the slot of the tick it
+ * is due in, so scheduling and cancelling are O(1), and run() only looks at
+ * the slots of the ticks that passed since its last call. Tasks more than one
+ * revolution (SLOTS * TICK_MS) ahead stay in their slot until their own
+ * revolution comes round.
+ */
+class TimerWheel
+{
+public:
+    static const uint8_t SLOTS = 64;
+    static const unsigned long TICK_MS = 250;
+
+    TimerWheel();
+
+    void schedule(TimerTask &task, unsigned long now, unsigned long delayMs);
+    void cancel(TimerTask &task);
+
+    // Runs every task due at now, earliest first; returns how many ran.
+    uint8_t run(unsigned long now);
+
+    // Milliseconds until the earliest scheduled task is due (0 if one is overdue), or ULONG_MAX when none is.
+    unsigned long timeUntilNext(unsigned long now) const;
+
+private:
+    static void link(TimerTask &task, TimerTask **list);
+    static void unlink(TimerTask &task);
+
+    TimerTask *slots[SLOTS];
+    TimerTask *ready;       // Tasks found due by the current run(), ordered by due time
+    unsigned long lastTick; // Tick of the last run()
+};
+
+#endif // TIMERWHEEL_H
@@ -1,10 +1,35 @@
 #include "Utils.h"
 #include "SharedStructs.h"
-#include <map>
+
+// Parses `count` decimal digits at `text`; fails on anything that is not a digit.
+static bool parseFixedDigits(const char *text, uint8_t count, int &value)
+{
+    value = 0;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        uint8_t digit = static_cast<uint8_t>(text[i] - '0');
+        if (digit > 9)
+            return false;
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date, without the per-year loop in makeTime.
+static long daysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    const long era = (year >= 0 ? year : year - 399) / 400;
+    const long yearOfEra = year - era * 400;
+    const long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
 
 /**
  * Converts an ISO8601 formatted time string to a time_t value, considering UTC offset.
- * It handles the year as an offset from 1970 to stay compatible with time_t definition.
+ * Only the fixed-width "YYYY-MM-DDTHH:MM" prefix used by Open-Meteo is accepted; it is
+ * decoded digit by digit instead of through sscanf and makeTime.
  *
  * @param iso8601 The ISO8601 formatted string.
  * @param utcOffsetSeconds The number of seconds to offset from UTC.
@@ -12,17 +37,17 @@
  */
 time_t iso8601ToTime(const char *iso8601, long utcOffsetSeconds)
 {
-    tmElements_t tm;
     int year, month, day, hour, minute;
-    if (sscanf(iso8601, "%4d-%2d-%2dT%2d:%2d", &year, &month, &day, &hour, &minute) == 5)
+    if (iso8601 != nullptr &&
+        parseFixedDigits(iso8601, 4, year) && iso8601[4] == '-' &&
+        parseFixedDigits(iso8601 + 5, 2, month) && iso8601[7] == '-' &&
+        parseFixedDigits(iso8601 + 8, 2, day) && iso8601[10] == 'T' &&
+        parseFixedDigits(iso8601 + 11, 2, hour) && iso8601[13] == ':' &&
+        parseFixedDigits(iso8601 + 14, 2, minute) &&
+        year >= 1970 && month >= 1 && month <= 12 && day >= 1 && day <= 31 && hour <= 23 && minute <= 59)
     {
-        tm.Year = year - 1970;
-        tm.Month = month;
-        tm.Day = day;
-        tm.Hour = hour;
-        tm.Minute = minute;
-        tm.Second = 0;
-        time_t time = makeTime(tm);
+        time_t time = static_cast<time_t>(daysFromCivil(year, month, day)) * SECS_PER_DAY +
+                      hour * SECS_PER_HOUR + minute * SECS_PER_MIN;
         return time != 0 ? time - utcOffsetSeconds : -1;
     }
     else
@@ -32,6 +57,25 @@ time_t iso8601ToTime(const char *iso8601, long utcOffsetSeconds)
     }
 }
 
+/**
+ * Checks whether the hour and minute fields of an ISO8601 string match a local time.
+ * Used to validate timestamps derived from a fixed stride without decoding the whole string.
+ *
+ * @param iso8601 The ISO8601 formatted string.
+ * @param localTime The expected time, already shifted to the string's UTC offset.
+ * @return true if "HH:MM" in the string equals the clock time of localTime.
+ */
+bool iso8601MatchesClock(const char *iso8601, time_t localTime)
+{
+    if (iso8601 == nullptr)
+        return false;
+    const long secondsOfDay = static_cast<long>(localTime % SECS_PER_DAY);
+    const int hour = secondsOfDay / SECS_PER_HOUR;
+    const int minute = (secondsOfDay / SECS_PER_MIN) % 60;
+    return iso8601[11] == '0' + hour / 10 && iso8601[12] == '0' + hour % 10 && iso8601[13] == ':' &&
+           iso8601[14] == '0' + minute / 10 && iso8601[15] == '0' + minute % 10;
+}
+
 /**
  * Formats a time_t value to an ISO 8601 date-time string.
  * Assumes the input time is in UTC.
@@ -92,32 +136,76 @@ void printHumanReadableTime(time_t rawTime, long utcOffsetSeconds)
     Serial.println(tm.Second);
 }
 
-// Map to associate strings with enum values for celestial objects.
-static const std::map<std::string, CelestialObject> nameToEnumMap = {
-     {"Moon", Moon},
-    {"Mercury", Mercury},
-    {"Venus", Venus},
-    {"Mars", Mars},
-    {"Jupiter", Jupiter},
-    {"Saturn", Saturn},
-    {"Uranus", Uranus},
-    {"Neptune", Neptune}
+// Names of the celestial objects, in CelestialObject order.
+constexpr const char *CELESTIAL_OBJECT_NAMES[] = {"Moon", "Mercury", "Venus", "Mars", "Jupiter", "Saturn", "Uranus", "Neptune"};
+static_assert(sizeof(CELESTIAL_OBJECT_NAMES) / sizeof(CELESTIAL_OBJECT_NAMES[0]) == Undefined, "one name per celestial object");
+
+const uint8_t NAME_HASH_SLOTS = 16;
+
+// The sum of the first two characters is distinct modulo 16 for all body names.
+constexpr uint8_t nameHash(const char *name)
+{
+    return (static_cast<uint8_t>(name[0]) + static_cast<uint8_t>(name[1])) % NAME_HASH_SLOTS;
+}
+
+struct NameHashTable
+{
+    uint8_t slots[NAME_HASH_SLOTS]; // CelestialObject whose name hashes here, or Undefined
+    bool isPerfect;
 };
 
+constexpr NameHashTable buildNameHashTable()
+{
+    NameHashTable table = {};
+    for (uint8_t slot = 0; slot < NAME_HASH_SLOTS; slot++)
+    {
+        table.slots[slot] = Undefined;
+    }
+    table.isPerfect = true;
+    for (uint8_t object = 0; object < Undefined; object++)
+    {
+        uint8_t &slot = table.slots[nameHash(CELESTIAL_OBJECT_NAMES[object])];
+        table.isPerfect = table.isPerfect && slot == Undefined;
+        slot = object;
+    }
+    return table;
+}
+
+// Name to CelestialObject lookup table, built and checked at compile time.
+constexpr NameHashTable NAME_HASH_TABLE = buildNameHashTable();
+static_assert(NAME_HASH_TABLE.isPerfect, "nameHash collides for two celestial object names");
+
+/**
+ * Returns the name of a celestial object, e.g. "Mars".
+ *
+ * @param object The celestial object.
+ * @return The name, or "Undefined" for Undefined.
+ */
+const char *celestialObjectName(CelestialObject object)
+{
+    return object < Undefined ? CELESTIAL_OBJECT_NAMES[object] : "Undefined";
+}
+
 /**
  * Converts a string to the corresponding CelestialObject enum value.
  * If the string does not match any celestial object, it returns Undefined.
+ * The lookup hashes the name into a compile-time table and confirms it with a single comparison.
  *
  * @param name The string representing the celestial object's name.
  * @return The corresponding CelestialObject enum value or Undefined if not found.
  */
-CelestialObject stringToEnum(const std::string& name) {
-    auto it = nameToEnumMap.find(name);
-    if (it != nameToEnumMap.end()) {
-        return it->second;
+CelestialObject stringToEnum(const char *name)
+{
+    if (name[0] != '\0')
+    {
+        uint8_t object = NAME_HASH_TABLE.slots[nameHash(name)];
+        if (object != Undefined && strcmp(CELESTIAL_OBJECT_NAMES[object], name) == 0)
+        {
+            return static_cast<CelestialObject>(object);
+        }
     }
     Serial.print("Error: '");
-    Serial.print(name.c_str());
+    Serial.print(name);
     Serial.println("' is not a valid celestial object name.");
     return CelestialObject::Undefined;
 }
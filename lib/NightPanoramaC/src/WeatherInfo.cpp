@@ -1,13 +1,109 @@
 #include <ESP8266HTTPClient.h>
-#include <ArduinoJson.h>
+#include <memory>
+#include <stdio.h>
+#include "Latency.h"
 #include "WeatherInfo.h"
+#include "WeatherParser.h"
 #include "Utils.h"
 
-// Constants
-const float DEW_POINT_DIFF_THRESHOLD = 2.0; // Threshold for dew point difference
+const char WEATHER_API_HOST[] = "api.open-meteo.com";
+
+static const char *apiHost = WEATHER_API_HOST;
+static uint16_t apiPort = WEATHER_API_PORT;
+
+/**
+ * Sends later weather queries to another server speaking the same protocol.
+ *
+ * @param host Host name or address; must stay valid while in use. nullptr restores the Open-Meteo default.
+ * @param port TCP port of the server.
+ */
+void setWeatherApiEndpoint(const char *host, uint16_t port) {
+    apiHost = host != nullptr ? host : WEATHER_API_HOST;
+    apiPort = host != nullptr ? port : WEATHER_API_PORT;
+}
+
+const char *weatherApiHost() {
+    return apiHost;
+}
+
+uint16_t weatherApiPort() {
+    return apiPort;
+}
+
+/**
+ * Writes the path and query of the Open-Meteo forecast request for a location.
+ *
+ * @param buffer Destination for the NUL-terminated path.
+ * @param size Size of buffer; WEATHER_QUERY_PATH_SIZE is always enough.
+ * @param location The geographical location (latitude and longitude).
+ * @param forecastHours Hourly values to request, starting with the current hour.
+ * @return The length of the path, as snprintf.
+ */
+int formatWeatherQueryPath(char *buffer, size_t size, const GeoLocation &location, uint8_t forecastHours) {
+    return snprintf(buffer, size,
+                    "/v1/forecast?latitude=%.6f&longitude=%.6f"
+                    "&current=is_day&hourly=temperature_2m,dew_point_2m,rain,cloud_cover"
+                    "&daily=sunrise,sunset,daylight_duration&timezone=auto&forecast_days=%u&forecast_hours=%u",
+                    location.latitude, location.longitude, static_cast<unsigned>(FORECAST_DAYS),
+                    static_cast<unsigned>(forecastHours));
+}
+
+/**
+ * Like formatWeatherQueryPath(buffer, size, location, forecastHours), but requests
+ * the hourly values of a fixed range of hours instead of a count from the current hour.
+ *
+ * @param firstHour First hour to request, in the location's local time.
+ * @param lastHour Last hour to request, included, in the location's local time.
+ */
+int formatWeatherQueryPath(char *buffer, size_t size, const GeoLocation &location, time_t firstHour, time_t lastHour) {
+    tmElements_t first;
+    tmElements_t last;
+    breakTime(firstHour, first);
+    breakTime(lastHour, last);
+    return snprintf(buffer, size,
+                    "/v1/forecast?latitude=%.6f&longitude=%.6f"
+                    "&current=is_day&hourly=temperature_2m,dew_point_2m,rain,cloud_cover"
+                    "&daily=sunrise,sunset,daylight_duration&timezone=auto&forecast_days=%u"
+                    "&start_hour=%04u-%02u-%02uT%02u:00&end_hour=%04u-%02u-%02uT%02u:00",
+                    location.latitude, location.longitude, static_cast<unsigned>(FORECAST_DAYS),
+                    first.Year + 1970u, first.Month, first.Day, first.Hour,
+                    last.Year + 1970u, last.Month, last.Day, last.Hour);
+}
+
+/**
+ * Reads an Open-Meteo forecast body from a stream and derives the night's weather.
+ * The body is parsed piece by piece as it is read; neither the body nor a JSON
+ * document is held in memory.
+ *
+ * @param stream The response body, positioned after the headers.
+ * @param info Receives the result; left untouched when false is returned.
+ * @return true if the body was complete and contained the required fields.
+ */
+bool parseWeatherResponse(Stream &stream, WeatherInfo &info) {
+    std::unique_ptr<WeatherParser> parser(new WeatherParser());
+    char chunk[256];
+    size_t length;
+
+    while (!parser->isComplete()) {
+        {
+            ScopedLatency timer(LATENCY_BODY_READ);
+            length = stream.readBytes(chunk, sizeof(chunk));
+        }
+        if (length == 0) {
+            break;
+        }
+        ScopedLatency timer(LATENCY_PARSE);
+        if (!parser->feed(chunk, length)) {
+            break;
+        }
+    }
+
+    return parser->finish(info);
+}
 
 /**
  * Fetches weather information for a given geographic location.
+ * The response is parsed by parseWeatherResponse as it is read from the connection.
  *
  * @param location The geographical location (latitude and longitude).
  * @return A WeatherInfo struct filled with weather data for the night period.
@@ -18,103 +114,26 @@ WeatherInfo getWeatherInfo(const GeoLocation &location) {
     HTTPClient http;
 
     // Compose API URL with the user's latitude and longitude
-    String url = "http://api.open-meteo.com/v1/forecast?latitude=" +
-                 String(location.latitude, 6) +
-                 "&longitude=" +
-                 String(location.longitude, 6) +
-                 "&current=is_day&hourly=temperature_2m,dew_point_2m,rain,cloud_cover&daily=sunrise,sunset&timezone=auto&forecast_days=3";
+    char path[WEATHER_QUERY_PATH_SIZE];
+    formatWeatherQueryPath(path, sizeof(path), location, FORECAST_HOURS);
+    String url = String("http://") + apiHost + ":" + String(static_cast<unsigned int>(apiPort)) + path;
 
+    // HTTP/1.0 keeps the body free of chunk markers so it can be parsed straight off the socket
+    http.useHTTP10(true);
     http.begin(client, url);
-    int httpCode = http.GET();
+    int httpCode;
+    {
+        // Connect, request and status line happen inside GET
+        ScopedLatency timer(LATENCY_HTTP_GET);
+        httpCode = http.GET();
+    }
     Serial.print("HTTP Response Code: ");
     Serial.println(httpCode);
 
     if (httpCode == HTTP_CODE_OK) {
-        const size_t capacity = 12288;
-        DynamicJsonDocument doc(capacity);
-        DeserializationError error = deserializeJson(doc, http.getString());
-
-        if (error) {
-            // Handle JSON parsing error
-            Serial.print(F("deserializeJson() failed with code "));
-            Serial.println(error.c_str());
-            http.end();
-            return info; // Return empty info struct
-        }
-
-        // Get the current time and UTC offset from the JSON
-        const char *currentTimeISO8601 = doc["current"]["time"];
-        long utcOffsetSeconds = doc["utc_offset_seconds"];
-
-        // Convert current time to time_t
-        time_t currentTime = iso8601ToTime(currentTimeISO8601, utcOffsetSeconds);
-
-        JsonObject hourly = doc["hourly"];
-        JsonArray timeArray = hourly["time"].as<JsonArray>();
-        JsonArray temperatureArray = hourly["temperature_2m"].as<JsonArray>();
-        JsonArray dewPointArray = hourly["dew_point_2m"].as<JsonArray>();
-        JsonArray rainArray = hourly["rain"].as<JsonArray>();
-        JsonArray cloudCoverArray = hourly["cloud_cover"].as<JsonArray>();
-
-        JsonObject daily = doc["daily"];
-        JsonArray sunriseArray = daily["sunrise"].as<JsonArray>();
-        JsonArray sunsetArray = daily["sunset"].as<JsonArray>();
-
-        // Convert the first sunset and sunrise times to time_t
-        time_t sunsetTime0 = iso8601ToTime(sunsetArray[0], utcOffsetSeconds);
-
-        // Check if the current time is past the time of sunset 0
-        if (currentTime > sunsetTime0) {
-            // If the current time is later than the time of sunset 0,
-            // then pick sunset 1 and sunrise 2
-            time_t sunsetTime1 = iso8601ToTime(sunsetArray[1], utcOffsetSeconds);
-            time_t sunriseTime2 = iso8601ToTime(sunriseArray[2], utcOffsetSeconds);
-
-            info.nextSunset = sunsetTime1;
-            info.nextSunrise = sunriseTime2;
-        } else {
-            // If the current time is earlier than the time of sunset 0,
-            // then pick sunset 0 and sunrise 1
-            time_t sunriseTime1 = iso8601ToTime(sunriseArray[1], utcOffsetSeconds);
-
-            info.nextSunset = sunsetTime0;
-            info.nextSunrise = sunriseTime1;
-        }
-
-        // Calculate the total rain amount and average cloud cover
-        uint16_t rainSum = 0;
-        uint16_t cloudCoverSum = 0;
-        uint16_t dataPoints = 0;
-
-        for (size_t i = 0; i < timeArray.size(); i++) {
-            time_t time = iso8601ToTime(timeArray[i], utcOffsetSeconds);
-
-            // If the time has surpassed the sunrise, exit the loop
-            if (time >= info.nextSunrise) {
-                break;
-            }
-
-            // Accumulate data only for the time window between sunset and sunrise
-            if (time >= info.nextSunset) {
-                rainSum += static_cast<uint16_t>(rainArray[i].as<float>());
-                cloudCoverSum += static_cast<uint16_t>(cloudCoverArray[i].as<float>());
-                dataPoints++;
-            }
-        }
-
-        if (dataPoints > 0) {
-            info.rainAmount = static_cast<uint8_t>(rainSum);
-            info.cloudCover = static_cast<uint8_t>(cloudCoverSum / dataPoints);
-        }
-
-        // Determine if dew is likely
-        for (size_t i = 0; i < temperatureArray.size(); i++) {
-            float temperature = temperatureArray[i];
-            float dewPoint = dewPointArray[i];
-            if (temperature - dewPoint < DEW_POINT_DIFF_THRESHOLD) {
-                info.isDew = true;
-                break;
-            }
+        if (!parseWeatherResponse(http.getStream(), info)) {
+            // Handle a truncated or malformed body
+            Serial.println(F("Weather response could not be parsed"));
         }
     } else {
         // Handle HTTP error by logging to Serial for debugging
@@ -3,15 +3,35 @@
 
 #include "SharedStructs.h"
 
+class Stream;
+
 struct WeatherInfo {
     float isDew;
     uint8_t rainAmount;
-    uint8_t cloudCover;
+    uint8_t cloudCover;    // Mean over the night, percent
+    uint8_t maxCloudCover; // Percent
+    uint8_t nightHours;    // Forecast hours between sunset and sunrise
+    uint8_t clearHours;    // Of those, hours without rain and with at most CLEAR_CLOUD_COVER percent cloud
     time_t nextSunset;
     time_t nextSunrise;
 
 };
 
+const uint8_t CLEAR_CLOUD_COVER = 20;
+
+// Open-Meteo endpoint queried by getWeatherInfo and StargazingFetcher, unless overridden
+extern const char WEATHER_API_HOST[];
+const uint16_t WEATHER_API_PORT = 80;
+const size_t WEATHER_QUERY_PATH_SIZE = 256;
+
+// Points the weather queries at another server, e.g. a local stand-in; nullptr restores the default.
+void setWeatherApiEndpoint(const char *host, uint16_t port);
+const char *weatherApiHost();
+uint16_t weatherApiPort();
+
+int formatWeatherQueryPath(char *buffer, size_t size, const GeoLocation &location, uint8_t forecastHours);
+int formatWeatherQueryPath(char *buffer, size_t size, const GeoLocation &location, time_t firstHour, time_t lastHour);
+bool parseWeatherResponse(Stream &stream, WeatherInfo &info);
 WeatherInfo getWeatherInfo(const GeoLocation& location);
 
 #endif // WEATHERINFO_H
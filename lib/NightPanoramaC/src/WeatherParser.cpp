@@ -0,0 +1,577 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Latency.h"
+#include "WeatherParser.h"
+#include "Utils.h"
+
+// Constants
+const float DEW_POINT_DIFF_THRESHOLD = 2.0; // Threshold for dew point difference
+const int16_t DEW_POINT_DIFF_THRESHOLD_TENTHS = static_cast<int16_t>(DEW_POINT_DIFF_THRESHOLD * 10);
+
+static int16_t toTenths(const char *number)
+{
+    return static_cast<int16_t>(lroundf(strtof(number, nullptr) * 10.0f));
+}
+
+WeatherParser::WeatherParser()
+{
+    reset();
+}
+
+void WeatherParser::reset()
+{
+    state = State::Value;
+    parsingKey = false;
+    depth = 0;
+    tokenLength = 0;
+    utcOffsetSeconds = 0;
+    currentTime = -1;
+    sunriseCount = 0;
+    sunsetCount = 0;
+    for (long &seconds : daylight)
+    {
+        seconds = -1;
+    }
+    sampleCount = 0;
+    strideStart = -1;
+    memset(samples, 0, sizeof(samples));
+}
+
+/**
+ * Feeds the next piece of the response body to the parser.
+ *
+ * @param data Bytes of the body, continuing where the previous call stopped.
+ * @param length Number of bytes in data.
+ * @return false once the input is known to be malformed; further input is ignored.
+ */
+bool WeatherParser::feed(const char *data, size_t length)
+{
+    for (size_t i = 0; i < length && state != State::Error; ++i)
+    {
+        if (!consume(data[i]))
+        {
+            state = State::Error;
+        }
+    }
+    return state != State::Error;
+}
+
+bool WeatherParser::push(bool isArray)
+{
+    if (depth >= MAX_DEPTH)
+    {
+        return false;
+    }
+    stack[depth].isArray = isArray;
+    stack[depth].key = Key::Other;
+    stack[depth].index = 0;
+    depth++;
+    state = isArray ? State::ArrayValueOrEnd : State::ObjectKeyOrEnd;
+    return true;
+}
+
+bool WeatherParser::pop(bool isArray)
+{
+    if (depth == 0 || stack[depth - 1].isArray != isArray)
+    {
+        return false;
+    }
+    depth--;
+    state = depth == 0 ? State::Done : State::AfterValue;
+    return true;
+}
+
+bool WeatherParser::consume(char c)
+{
+    const bool isSpace = c == ' ' || c == '\n' || c == '\r' || c == '\t';
+
+    switch (state)
+    {
+    case State::ArrayValueOrEnd:
+        if (isSpace)
+            return true;
+        if (c == ']')
+            return pop(true);
+        state = State::Value;
+        return consume(c);
+
+    case State::Value:
+        if (isSpace)
+            return true;
+        if (c == '{')
+            return push(false);
+        if (c == '[')
+            return push(true);
+        tokenLength = 0;
+        if (c == '"')
+        {
+            parsingKey = false;
+            state = State::String;
+            return true;
+        }
+        if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n')
+        {
+            token[tokenLength++] = c;
+            state = State::Literal;
+            return true;
+        }
+        return false;
+
+    case State::ObjectKeyOrEnd:
+    case State::Key:
+        if (isSpace)
+            return true;
+        if (c == '}' && state == State::ObjectKeyOrEnd)
+            return pop(false);
+        if (c != '"')
+            return false;
+        tokenLength = 0;
+        parsingKey = true;
+        state = State::String;
+        return true;
+
+    case State::Colon:
+        if (isSpace)
+            return true;
+        if (c != ':')
+            return false;
+        state = State::Value;
+        return true;
+
+    case State::String:
+        if (c == '\\')
+        {
+            state = State::StringEscape;
+            return true;
+        }
+        if (c == '"')
+        {
+            token[tokenLength] = '\0';
+            if (parsingKey)
+            {
+                onKey();
+                state = State::Colon;
+            }
+            else
+            {
+                onScalar(true);
+                state = State::AfterValue;
+            }
+            return true;
+        }
+        if (tokenLength < TOKEN_SIZE - 1)
+            token[tokenLength++] = c;
+        return true;
+
+    case State::StringEscape:
+        // Escapes never occur in the consumed fields; keep the character and move on
+        if (tokenLength < TOKEN_SIZE - 1)
+            token[tokenLength++] = c;
+        state = State::String;
+        return true;
+
+    case State::Literal:
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '.' || c == '-' || c == '+' || c == 'E')
+        {
+            if (tokenLength < TOKEN_SIZE - 1)
+                token[tokenLength++] = c;
+            return true;
+        }
+        token[tokenLength] = '\0';
+        onScalar(false);
+        state = State::AfterValue;
+        return consume(c);
+
+    case State::AfterValue:
+        if (depth == 0)
+        {
+            // A scalar at the top level is the whole document; only whitespace may follow
+            if (!isSpace)
+                return false;
+            state = State::Done;
+            return true;
+        }
+        if (isSpace)
+            return true;
+        if (c == ',')
+        {
+            if (stack[depth - 1].isArray)
+            {
+                stack[depth - 1].index++;
+                state = State::Value;
+            }
+            else
+            {
+                state = State::Key;
+            }
+            return true;
+        }
+        if (c == '}')
+            return pop(false);
+        if (c == ']')
+            return pop(true);
+        return false;
+
+    case State::Done:
+        return isSpace;
+
+    case State::Error:
+    default:
+        return false;
+    }
+}
+
+void WeatherParser::onKey()
+{
+    // Keys that lead to a consumed value; any other key maps to Other
+    static const struct
+    {
+        const char *name;
+        Key key;
+    } keyNames[] = {
+        {"utc_offset_seconds", Key::UtcOffset},
+        {"current", Key::Current},
+        {"hourly", Key::Hourly},
+        {"daily", Key::Daily},
+        {"time", Key::Time},
+        {"temperature_2m", Key::Temperature},
+        {"dew_point_2m", Key::DewPoint},
+        {"rain", Key::Rain},
+        {"cloud_cover", Key::CloudCover},
+        {"sunrise", Key::Sunrise},
+        {"sunset", Key::Sunset},
+        {"daylight_duration", Key::DaylightDuration}};
+
+    Key key = Key::Other;
+    for (const auto &entry : keyNames)
+    {
+        if (strcmp(token, entry.name) == 0)
+        {
+            key = entry.key;
+            break;
+        }
+    }
+    stack[depth - 1].key = key;
+}
+
+void WeatherParser::onScalar(bool isString)
+{
+    if (depth == 1 && stack[0].key == Key::UtcOffset && !isString)
+    {
+        utcOffsetSeconds = atol(token);
+        return;
+    }
+
+    if (depth == 2 && stack[0].key == Key::Current && stack[1].key == Key::Time && isString)
+    {
+        currentTime = iso8601ToTime(token, 0);
+        return;
+    }
+
+    if (depth != 3 || !stack[2].isArray)
+    {
+        return;
+    }
+
+    const uint16_t index = stack[2].index;
+    const Key section = stack[0].key;
+    const Key field = stack[1].key;
+
+    if (section == Key::Daily && index < FORECAST_DAYS && field == Key::DaylightDuration && !isString)
+    {
+        daylight[index] = lroundf(strtof(token, nullptr));
+        return;
+    }
+
+    if (section == Key::Daily && index < FORECAST_DAYS && isString)
+    {
+        if (field == Key::Sunrise)
+        {
+            sunrise[index] = iso8601ToTime(token, 0);
+            sunriseCount = index + 1;
+        }
+        else if (field == Key::Sunset)
+        {
+            sunset[index] = iso8601ToTime(token, 0);
+            sunsetCount = index + 1;
+        }
+        return;
+    }
+
+    if (section != Key::Hourly || index >= MAX_HOURLY_SAMPLES)
+    {
+        return;
+    }
+
+    HourlySample &sample = samples[index];
+    switch (field)
+    {
+    case Key::Time:
+        if (isString)
+            onHourlyTime(index);
+        break;
+    case Key::Temperature:
+        sample.temperature = toTenths(token);
+        break;
+    case Key::DewPoint:
+        sample.dewPoint = toTenths(token);
+        break;
+    case Key::Rain:
+        sample.rain = static_cast<uint16_t>(toTenths(token));
+        break;
+    case Key::CloudCover:
+        sample.cloudCover = static_cast<uint8_t>(atoi(token));
+        break;
+    default:
+        break;
+    }
+}
+
+// Hourly entries are a fixed one-hour stride, so only the first one is decoded.
+// Each derived time is checked against the entry's HH:MM digits; a mismatch
+// (e.g. a DST jump in local time) decodes that entry and re-anchors the stride.
+void WeatherParser::onHourlyTime(uint16_t index)
+{
+    time_t time = strideStart + static_cast<time_t>(index) * SECS_PER_HOUR;
+    if (strideStart < 0 || !iso8601MatchesClock(token, time))
+    {
+        time = iso8601ToTime(token, 0);
+        strideStart = time < 0 ? -1 : time - static_cast<time_t>(index) * SECS_PER_HOUR;
+    }
+    samples[index].time = time;
+    sampleCount = index + 1;
+}
+
+// Picks the coming night's sunset and sunrise, in UTC; false unless the response was complete.
+bool WeatherParser::selectNight(WeatherInfo &info) const
+{
+    if (state != State::Done || currentTime < 0 || sunsetCount < 2 || sunriseCount < 3)
+    {
+        return false;
+    }
+
+    ScopedLatency timer(LATENCY_NIGHT_SELECT);
+
+    // If the current time is later than the time of sunset 0,
+    // then pick sunset 1 and sunrise 2, otherwise sunset 0 and sunrise 1
+    const uint8_t day = currentTime > sunset[0] ? 1 : 0;
+    time_t start = sunset[day];
+    time_t end = sunrise[day + 1];
+
+    if (isPolar(day, true))
+    {
+        // The sun does not set: no night, only an empty window at the start of the next day
+        start = sunset[day] + SECS_PER_DAY;
+        end = start;
+    }
+    else if (!isPolar(day, false) && isPolar(day + 1, false))
+    {
+        // The night after this sunset runs on through the following sunless day
+        end = sunrise[day + 1] + SECS_PER_DAY;
+    }
+    // In polar night the window already is the whole day: 00:00 to the next sunrise or 00:00
+
+    info.nextSunset = start - utcOffsetSeconds;
+    info.nextSunrise = end - utcOffsetSeconds;
+    return true;
+}
+
+/**
+ * Whether the sun neither rises nor sets on a day. Open-Meteo gives such a day
+ * 00:00 for both sunrise and sunset; its daylight duration tells polar day from
+ * polar night. Without the daylight duration no day counts as polar.
+ *
+ * @param day Index into the daily arrays.
+ * @param isLit true to ask for polar day, false for polar night.
+ */
+bool WeatherParser::isPolar(uint8_t day, bool isLit) const
+{
+    if (sunrise[day] != sunset[day] || daylight[day] < 0)
+    {
+        return false;
+    }
+    return isLit ? daylight[day] > SECS_PER_DAY / 2 : daylight[day] <= SECS_PER_DAY / 2;
+}
+
+void NightAggregator::begin(time_t windowStart, time_t windowEnd)
+{
+    sunset = windowStart;
+    sunrise = windowEnd;
+    rainSum = 0;
+    cloudCoverSum = 0;
+    maxCloudCover = 0;
+    hours = 0;
+    clearHours = 0;
+    isDew = false;
+}
+
+bool NightAggregator::add(const HourlySample &sample, long utcOffsetSeconds)
+{
+    const time_t time = sample.time - utcOffsetSeconds;
+
+    // If the time has surpassed the sunrise, the window is over
+    if (time >= sunrise)
+    {
+        return false;
+    }
+
+    // Accumulate data only for the time window between sunset and sunrise
+    if (time < sunset)
+    {
+        return true;
+    }
+    rainSum += sample.rain / 10;
+    cloudCoverSum += sample.cloudCover;
+    if (sample.cloudCover > maxCloudCover)
+    {
+        maxCloudCover = sample.cloudCover;
+    }
+    if (sample.rain == 0 && sample.cloudCover <= CLEAR_CLOUD_COVER)
+    {
+        clearHours++;
+    }
+    if (sample.temperature - sample.dewPoint < DEW_POINT_DIFF_THRESHOLD_TENTHS)
+    {
+        isDew = true;
+    }
+    hours++;
+    return true;
+}
+
+void NightAggregator::finish(WeatherInfo &info) const
+{
+    info.isDew = isDew;
+    info.nightHours = hours;
+    info.clearHours = clearHours;
+    if (hours > 0)
+    {
+        info.rainAmount = static_cast<uint8_t>(rainSum);
+        info.cloudCover = static_cast<uint8_t>(cloudCoverSum / hours);
+        info.maxCloudCover = maxCloudCover;
+    }
+}
+
+// Summarizes info's sunset-to-sunrise window from time-ordered samples in one sweep.
+static void summarizeNight(const HourlySample *samples, uint8_t count, long utcOffsetSeconds, WeatherInfo &info)
+{
+    ScopedLatency timer(LATENCY_AGGREGATE);
+
+    NightAggregator night;
+    night.begin(info.nextSunset, info.nextSunrise);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!night.add(samples[i], utcOffsetSeconds))
+        {
+            break;
+        }
+    }
+    night.finish(info);
+}
+
+/**
+ * Derives the weather for the coming night from a completely parsed response:
+ * the next sunset/sunrise pair and, for the hours between them, rain, mean and
+ * peak cloud cover, the number of clear hours and whether dew is likely.
+ *
+ * @param info Receives the result; left untouched when false is returned.
+ * @return true if the response was complete and contained the required fields.
+ */
+bool WeatherParser::finish(WeatherInfo &info) const
+{
+    WeatherInfo result = {};
+    if (!selectNight(result))
+    {
+        return false;
+    }
+    summarizeNight(samples, sampleCount, utcOffsetSeconds, result);
+    info = result;
+    return true;
+}
+
+/**
+ * Like finish(info), but first merges the parsed hours into a series kept
+ * between fetches and summarizes the night from that series, so hours that
+ * were not requested again still count.
+ *
+ * @param info Receives the result; left untouched when false is returned.
+ * @param series The retained forecast; updated only when true is returned.
+ * @return true if the response was complete and contained the required fields.
+ */
+bool WeatherParser::finish(WeatherInfo &info, ForecastSeries &series) const
+{
+    WeatherInfo result = {};
+    if (!selectNight(result))
+    {
+        return false;
+    }
+    series.merge(samples, sampleCount, utcOffsetSeconds, currentTime - utcOffsetSeconds);
+    series.summarize(result);
+    info = result;
+    return true;
+}
+
+void ForecastSeries::clear()
+{
+    count = 0;
+    asOf = -1;
+}
+
+/**
+ * Merges freshly parsed hours into the series. The fresh hours replace retained
+ * ones in the range they cover; retained hours outside that range are kept.
+ * When the result does not fit, the oldest hours are dropped.
+ *
+ * @param fresh Consecutive hourly samples in local time, ordered by time.
+ * @param freshCount Number of fresh samples.
+ * @param utcOffsetSeconds Offset of the local times in fresh.
+ * @param freshAsOf UTC time of the response fresh was parsed from.
+ */
+void ForecastSeries::merge(const HourlySample *fresh, uint8_t freshCount, long utcOffsetSeconds, time_t freshAsOf)
+{
+    asOf = freshAsOf;
+    if (freshCount == 0)
+    {
+        return;
+    }
+
+    const time_t first = fresh[0].time - utcOffsetSeconds;
+    const time_t last = fresh[freshCount - 1].time - utcOffsetSeconds;
+
+    // Retained hours before and after the fresh range
+    uint8_t before = 0;
+    while (before < count && samples[before].time < first)
+    {
+        before++;
+    }
+    uint8_t after = before;
+    while (after < count && samples[after].time <= last)
+    {
+        after++;
+    }
+    const uint8_t afterCount = count - after;
+
+    // Drop the oldest hours first; the fresh range and what follows it matter more
+    const size_t total = static_cast<size_t>(before) + freshCount + afterCount;
+    uint8_t skip = total > MAX_HOURLY_SAMPLES ? static_cast<uint8_t>(total - MAX_HOURLY_SAMPLES) : 0;
+    const uint8_t keepBefore = skip < before ? before - skip : 0;
+    skip = skip > before ? skip - before : 0;
+
+    // Move the kept head down, then the retained tail into place, then copy the fresh hours between them;
+    // the head only moves towards the front, so it never overwrites the tail before that is moved
+    const uint8_t freshKept = skip < freshCount ? freshCount - skip : 0;
+    const uint8_t afterKept = skip > freshCount ? afterCount - (skip - freshCount) : afterCount;
+    memmove(&samples[0], &samples[before - keepBefore], keepBefore * sizeof(HourlySample));
+    memmove(&samples[keepBefore + freshKept], &samples[count - afterKept], afterKept * sizeof(HourlySample));
+    for (uint8_t i = 0; i < freshKept; i++)
+    {
+        samples[keepBefore + i] = fresh[freshCount - freshKept + i];
+        samples[keepBefore + i].time -= utcOffsetSeconds;
+    }
+    count = keepBefore + freshKept + afterKept;
+}
+
+void ForecastSeries::summarize(WeatherInfo &info) const
+{
+    summarizeNight(samples, count, 0, info);
+}
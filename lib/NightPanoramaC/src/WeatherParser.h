@@ -0,0 +1,177 @@
+#ifndef WEATHERPARSER_H
+#define WEATHERPARSER_H
+
+#include "WeatherInfo.h"
+
+const uint8_t FORECAST_DAYS = 3; // Days of sunrise/sunset requested; sunrise[2] is needed after sunset
+
+// Hours requested when nothing is known about the coming night yet. Counting from the
+// current hour, the window of the next night (at the latest sunset[1] to sunrise[2])
+// ends within this span wherever the sun sets and rises daily.
+const uint8_t FORECAST_HOURS = 48;
+const uint8_t MAX_HOURLY_SAMPLES = FORECAST_HOURS;
+
+// One hour of the forecast, in fixed point so a whole series fits in under 1 KB.
+struct HourlySample
+{
+    time_t time;         // Local time as parsed; UTC once merged into a ForecastSeries
+    int16_t temperature; // Tenths of a degree Celsius
+    int16_t dewPoint;    // Tenths of a degree Celsius
+    uint16_t rain;       // Tenths of a millimetre
+    uint8_t cloudCover;  // Percent
+};
+
+/**
+ * Single-pass summary of the hours between a sunset and the following sunrise.
+ * Samples are fed one at a time in time order, straight from wherever they are
+ * held; rain, cloud cover, dew and the hour counts are accumulated as they go,
+ * and hours outside the window are ignored.
+ */
+class NightAggregator
+{
+public:
+    NightAggregator() { begin(0, 0); }
+
+    void begin(time_t sunset, time_t sunrise);
+
+    // Consumes one sample; returns false once the window is over, so the caller can stop feeding.
+    bool add(const HourlySample &sample, long utcOffsetSeconds = 0);
+
+    // Fills rain, cloud cover, dew and the hour counts of info; rain and cloud stay untouched without hours.
+    void finish(WeatherInfo &info) const;
+
+private:
+    time_t sunset;
+    time_t sunrise;
+    uint16_t rainSum;
+    uint16_t cloudCoverSum;
+    uint8_t maxCloudCover;
+    uint8_t hours;
+    uint8_t clearHours;
+    bool isDew;
+};
+
+/**
+ * Hourly forecast kept between fetches, in UTC and ordered by time.
+ * A refresh only has to download the hours that are still ahead; the hours it
+ * returns replace the retained ones, and earlier hours are kept.
+ */
+class ForecastSeries
+{
+public:
+    ForecastSeries() : count(0), asOf(-1) {}
+
+    void clear();
+    bool isEmpty() const { return count == 0; }
+
+    // UTC time of the response the series was last updated from, or -1.
+    time_t getAsOf() const { return asOf; }
+
+    void merge(const HourlySample *fresh, uint8_t freshCount, long utcOffsetSeconds, time_t freshAsOf);
+
+    // Fills the weather of info for its sunset-to-sunrise window.
+    void summarize(WeatherInfo &info) const;
+
+private:
+    HourlySample samples[MAX_HOURLY_SAMPLES];
+    uint8_t count;
+    time_t asOf;
+};
+
+/**
+ * Resumable parser for the Open-Meteo forecast response.
+ * Bytes can be fed in arbitrarily sized pieces as they arrive from the network;
+ * only the fields used for WeatherInfo are kept, so no part of the body and no
+ * JSON document is ever held in memory.
+ */
+class WeatherParser
+{
+public:
+    WeatherParser();
+
+    void reset();
+    bool feed(const char *data, size_t length);
+    bool isComplete() const { return state == State::Done; }
+    bool hasFailed() const { return state == State::Error; }
+
+    // Offset of the local times in the response, e.g. for requesting hours in local time.
+    long utcOffset() const { return utcOffsetSeconds; }
+
+    // Derives the night's WeatherInfo; returns false unless a complete, usable response was parsed.
+    bool finish(WeatherInfo &info) const;
+
+    // Same, after merging the parsed hours into series; the night is then summarized from the series.
+    bool finish(WeatherInfo &info, ForecastSeries &series) const;
+
+private:
+    enum class State : uint8_t
+    {
+        Value,
+        ArrayValueOrEnd,
+        ObjectKeyOrEnd,
+        Key,
+        Colon,
+        String,
+        StringEscape,
+        Literal,
+        AfterValue,
+        Done,
+        Error
+    };
+
+    enum class Key : uint8_t
+    {
+        Other,
+        UtcOffset,
+        Current,
+        Hourly,
+        Daily,
+        Time,
+        Temperature,
+        DewPoint,
+        Rain,
+        CloudCover,
+        Sunrise,
+        Sunset,
+        DaylightDuration
+    };
+
+    struct Level
+    {
+        bool isArray;
+        Key key;        // Member being parsed, for objects
+        uint16_t index; // Element being parsed, for arrays
+    };
+
+    static const uint8_t MAX_DEPTH = 6;
+    static const uint8_t TOKEN_SIZE = 24;
+
+    bool consume(char c);
+    bool push(bool isArray);
+    bool pop(bool isArray);
+    void onKey();
+    void onScalar(bool isString);
+    void onHourlyTime(uint16_t index);
+    bool selectNight(WeatherInfo &info) const;
+    bool isPolar(uint8_t day, bool isLit) const;
+
+    State state;
+    bool parsingKey;
+    uint8_t depth;
+    Level stack[MAX_DEPTH];
+    char token[TOKEN_SIZE];
+    uint8_t tokenLength;
+
+    long utcOffsetSeconds;
+    time_t currentTime;
+    time_t sunrise[FORECAST_DAYS];
+    time_t sunset[FORECAST_DAYS];
+    uint8_t sunriseCount;
+    uint8_t sunsetCount;
+    long daylight[FORECAST_DAYS]; // Seconds of daylight per day; -1 if not in the response
+    HourlySample samples[MAX_HOURLY_SAMPLES];
+    uint8_t sampleCount;
+    time_t strideStart;
+};
+
+#endif // WEATHERPARSER_H
@@ -0,0 +1,53 @@
+#include "ChunkedResponse.h"
+
+ChunkedResponse::ChunkedResponse(ESP8266WebServer &server) : server(server), length(0)
+{
+}
+
+void ChunkedResponse::begin(int code, const char *contentType)
+{
+  length = 0;
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(code, contentType, "");
+}
+
+size_t ChunkedResponse::write(uint8_t c)
+{
+  if (length == BUFFER_SIZE)
+  {
+    sendBuffer();
+  }
+  buffer[length++] = static_cast<char>(c);
+  return 1;
+}
+
+size_t ChunkedResponse::write(const uint8_t *data, size_t size)
+{
+  for (size_t written = 0; written < size;)
+  {
+    if (length == BUFFER_SIZE)
+    {
+      sendBuffer();
+    }
+    size_t count = min(size - written, BUFFER_SIZE - length);
+    memcpy(buffer + length, data + written, count);
+    length += count;
+    written += count;
+  }
+  return size;
+}
+
+void ChunkedResponse::end()
+{
+  sendBuffer();
+  server.sendContent(""); // Terminating chunk
+}
+
+void ChunkedResponse::sendBuffer()
+{
+  if (length > 0)
+  {
+    server.sendContent(buffer, length);
+    length = 0;
+  }
+}
@@ -0,0 +1,63 @@
+#include "LedFramebuffer.h"
+
+LedFramebuffer::LedFramebuffer(LedControl &lc) : lc(lc)
+{
+  memset(rows, 0, sizeof(rows));
+  memset(shownRows, 0, sizeof(shownRows));
+}
+
+void LedFramebuffer::clear()
+{
+  memset(rows, 0, sizeof(rows));
+}
+
+void LedFramebuffer::setPixel(int row, int col)
+{
+  if (row < 0 || row >= ROWS || col < 0 || col >= COLUMNS)
+  {
+    return;
+  }
+  rows[row] |= 0x80000000UL >> col;
+}
+
+void LedFramebuffer::blit(const uint32_t *sprite)
+{
+  if (sprite == nullptr)
+  {
+    return;
+  }
+  for (uint8_t row = 0; row < ROWS; row++)
+  {
+    rows[row] |= pgm_read_dword(&sprite[row]);
+  }
+}
+
+void LedFramebuffer::flush()
+{
+  for (uint8_t row = 0; row < ROWS; row++)
+  {
+    uint32_t changed = rows[row] ^ shownRows[row];
+    if (changed == 0)
+    {
+      continue;
+    }
+
+    for (uint8_t device = 0; device < DEVICES; device++)
+    {
+      uint8_t shift = (DEVICES - 1 - device) * 8;
+      if ((changed >> shift) & 0xFF)
+      {
+        lc.setRow(device, row, static_cast<byte>(rows[row] >> shift));
+      }
+    }
+    shownRows[row] = rows[row];
+  }
+}
+
+void LedFramebuffer::invalidate()
+{
+  for (uint8_t row = 0; row < ROWS; row++)
+  {
+    shownRows[row] = ~rows[row];
+  }
+}
@@ -0,0 +1,41 @@
+#include <ESP8266WiFi.h>
+#include "PowerManager.h"
+#include "Telemetry.h"
+
+PowerManager::PowerManager(PowerMode mode) : mode(mode), planner(MAX_SLEEP_MS, AWAKE_AFTER_REQUEST_MS)
+{
+}
+
+void PowerManager::begin()
+{
+  switch (mode)
+  {
+  case PowerMode::Modem:
+    WiFi.setSleepMode(WIFI_MODEM_SLEEP, LISTEN_INTERVAL);
+    break;
+  case PowerMode::Light:
+    WiFi.setSleepMode(WIFI_LIGHT_SLEEP, LISTEN_INTERVAL);
+    break;
+  default:
+    WiFi.setSleepMode(WIFI_NONE_SLEEP);
+    break;
+  }
+}
+
+void PowerManager::idle(unsigned long timeUntilNext)
+{
+  if (mode == PowerMode::Awake)
+  {
+    return;
+  }
+  const unsigned long start = millis();
+  const unsigned long sleepMs = planner.plan(start, timeUntilNext);
+  if (sleepMs == 0)
+  {
+    return;
+  }
+  delay(sleepMs);
+  const unsigned long idleMs = millis() - start;
+  planner.recordIdle(idleMs);
+  recordIdle(idleMs);
+}
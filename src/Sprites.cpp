@@ -0,0 +1,134 @@
+#include "Sprites.h"
+
+// Scenes are drawn as pictures and folded into row bitmaps at compile time.
+
+const Sprite SPRITE_SUN_AND_EARTH PROGMEM = {
+  spriteRow("##.............................."),
+  spriteRow("###............................."),
+  spriteRow("###............................."),
+  spriteRow("####............................"),
+  spriteRow("####.......##..................."),
+  spriteRow("###........##..................."),
+  spriteRow("###............................."),
+  spriteRow("##..............................")};
+
+const Sprite SPRITE_STARS PROGMEM = {
+  spriteRow("..#...#..#..#....#...#.#...#..#."),
+  spriteRow("#....#.....#..#...#...#..#.....#"),
+  spriteRow("...#...#..#..#......#.......#..."),
+  spriteRow("................................"),
+  spriteRow("...###...###......###.......###."),
+  spriteRow("...###...###......###.......###."),
+  spriteRow("....#.....#........#.........#.."),
+  spriteRow("################################")};
+
+const Sprite SPRITE_CLOUDS PROGMEM = {
+  spriteRow("..###....###....###....###......"),
+  spriteRow("#####...#####...#####...#####..."),
+  spriteRow("..###....###...###....###......."),
+  spriteRow("................................"),
+  spriteRow("...###...###......###.......###."),
+  spriteRow("...###...###......###.......###."),
+  spriteRow("....#.....#........#.........#.."),
+  spriteRow("################################")};
+
+static const Sprite SPRITE_MOON PROGMEM = {
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("............#..................."),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................")};
+
+static const Sprite SPRITE_MERCURY PROGMEM = {
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow(".....##........................."),
+  spriteRow(".....##........................."),
+  spriteRow("................................"),
+  spriteRow("................................")};
+
+static const Sprite SPRITE_VENUS PROGMEM = {
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("........##......................"),
+  spriteRow("........##......................"),
+  spriteRow("................................"),
+  spriteRow("................................")};
+
+static const Sprite SPRITE_MARS PROGMEM = {
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("..............##................"),
+  spriteRow("..............##................"),
+  spriteRow("................................"),
+  spriteRow("................................")};
+
+static const Sprite SPRITE_JUPITER PROGMEM = {
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("..................###..........."),
+  spriteRow("..................###..........."),
+  spriteRow("..................###..........."),
+  spriteRow("................................")};
+
+static const Sprite SPRITE_SATURN PROGMEM = {
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow(".......................##......."),
+  spriteRow(".......................##......."),
+  spriteRow("................................"),
+  spriteRow("................................")};
+
+static const Sprite SPRITE_URANUS PROGMEM = {
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("..........................##...."),
+  spriteRow("..........................##...."),
+  spriteRow("................................"),
+  spriteRow("................................")};
+
+static const Sprite SPRITE_NEPTUNE PROGMEM = {
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow("................................"),
+  spriteRow(".............................##."),
+  spriteRow(".............................##."),
+  spriteRow("................................"),
+  spriteRow("................................")};
+
+// Indexed by CelestialObject, so the order must follow the enum.
+static const uint32_t *const PLANET_SPRITES[] PROGMEM = {
+  SPRITE_MOON,
+  SPRITE_MERCURY,
+  SPRITE_VENUS,
+  SPRITE_MARS,
+  SPRITE_JUPITER,
+  SPRITE_SATURN,
+  SPRITE_URANUS,
+  SPRITE_NEPTUNE};
+static_assert(sizeof(PLANET_SPRITES) / sizeof(PLANET_SPRITES[0]) == Undefined, "one sprite per CelestialObject");
+
+const uint32_t *planetSprite(CelestialObject object)
+{
+  if (object >= Undefined)
+  {
+    return nullptr;
+  }
+  return static_cast<const uint32_t *>(pgm_read_ptr(&PLANET_SPRITES[object]));
+}
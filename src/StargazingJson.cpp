@@ -0,0 +1,43 @@
+#include <ArduinoJson.h>
+#include "StargazingJson.h"
+
+// Every member is a fixed number of slots; keys and body names are not copied into the pool.
+const size_t STARGAZING_JSON_CAPACITY =
+    JSON_OBJECT_SIZE(2) +                       // Root: weather, bodies
+    JSON_OBJECT_SIZE(8) +                       // Weather
+    JSON_ARRAY_SIZE(MAX_CELESTIAL_BODIES) +     // Bodies
+    MAX_CELESTIAL_BODIES * JSON_OBJECT_SIZE(6); // Each body
+
+size_t serializeStargazingInfo(const StargazingInfo &info, char *buffer, size_t size)
+{
+  StaticJsonDocument<STARGAZING_JSON_CAPACITY> doc;
+
+  JsonObject weather = doc.createNestedObject("weather");
+  weather["isDew"] = info.weather.isDew != 0;
+  weather["rainAmount"] = info.weather.rainAmount;
+  weather["cloudCover"] = info.weather.cloudCover;
+  weather["maxCloudCover"] = info.weather.maxCloudCover;
+  weather["nightHours"] = info.weather.nightHours;
+  weather["clearHours"] = info.weather.clearHours;
+  weather["nextSunset"] = static_cast<long>(info.weather.nextSunset);
+  weather["nextSunrise"] = static_cast<long>(info.weather.nextSunrise);
+
+  JsonArray bodies = doc.createNestedArray("bodies");
+  for (uint8_t i = 0; i < info.celestial.bodyCount; i++)
+  {
+    const CelestialBodyInfo &source = info.celestial.bodies[i];
+    JsonObject body = bodies.createNestedObject();
+    body["name"] = static_cast<const char *>(source.name); // Stored by reference; info outlives doc
+    body["riseTime"] = static_cast<long>(source.riseAndSet.riseTime);
+    body["setTime"] = static_cast<long>(source.riseAndSet.setTime);
+    body["altitude"] = source.positionCulmination.hc;
+    body["azimuth"] = source.positionCulmination.zn;
+    body["isVisible"] = source.isVisible;
+  }
+
+  if (doc.overflowed() || measureJson(doc) >= size)
+  {
+    return 0;
+  }
+  return serializeJson(doc, buffer, size);
+}
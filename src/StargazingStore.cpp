@@ -0,0 +1,76 @@
+#include <LittleFS.h>
+#include "StargazingStore.h"
+
+static const char RECORD_PATH[] = "/stargazing.bin";
+static const char TEMP_PATH[] = "/stargazing.tmp";
+
+// Reads the stored record; returns its length, or 0 if there is none.
+static size_t readRecord(uint8_t *buffer, size_t size)
+{
+  File file = LittleFS.open(RECORD_PATH, "r");
+  if (!file)
+  {
+    return 0;
+  }
+  size_t length = file.read(buffer, size);
+  file.close();
+  return length;
+}
+
+bool beginStargazingStore()
+{
+  if (!LittleFS.begin())
+  {
+    Serial.println("LittleFS mount failed");
+    return false;
+  }
+  return true;
+}
+
+bool loadStargazingSnapshot(StargazingSnapshot &snapshot)
+{
+  uint8_t record[STARGAZING_RECORD_SIZE];
+  size_t length = readRecord(record, sizeof(record));
+  if (length == 0)
+  {
+    return false;
+  }
+  if (!decodeStargazingRecord(record, length, snapshot))
+  {
+    Serial.println("Stored stargazing record is invalid, ignoring it");
+    return false;
+  }
+  return true;
+}
+
+bool saveStargazingSnapshot(const StargazingSnapshot &snapshot)
+{
+  uint8_t record[STARGAZING_RECORD_SIZE];
+  size_t length = encodeStargazingRecord(snapshot, record, sizeof(record));
+  if (length == 0)
+  {
+    return false;
+  }
+
+  uint8_t stored[STARGAZING_RECORD_SIZE];
+  if (readRecord(stored, sizeof(stored)) == length && memcmp(stored, record, length) == 0)
+  {
+    return true;
+  }
+
+  // Write a temporary file and rename it, so a reset mid-write leaves the old record intact
+  File file = LittleFS.open(TEMP_PATH, "w");
+  if (!file)
+  {
+    return false;
+  }
+  bool isWritten = file.write(record, length) == length;
+  file.close();
+  if (!isWritten || !LittleFS.rename(TEMP_PATH, RECORD_PATH))
+  {
+    Serial.println("Saving the stargazing record failed");
+    LittleFS.remove(TEMP_PATH);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,189 @@
+#include <stdarg.h>
+#include "Latency.h"
+#include "Telemetry.h"
+
+// Lower-case phase names, used as the Prometheus "phase" label.
+static const char *const PHASE_NAMES[PHASE_COUNT] = {"fetch", "http", "render"};
+
+static PhaseMemory phases[PHASE_COUNT];
+static uint64_t idleMillis = 0;
+
+void Gauge::update(uint32_t value)
+{
+  current = value;
+  if (value < min)
+  {
+    min = value;
+  }
+  if (value > max)
+  {
+    max = value;
+  }
+}
+
+static void resetGauge(Gauge &gauge)
+{
+  gauge.current = 0;
+  gauge.min = UINT32_MAX;
+  gauge.max = 0;
+}
+
+void sampleMemory(Phase phase)
+{
+  PhaseMemory &memory = phases[static_cast<uint8_t>(phase)];
+  const unsigned long now = millis();
+  const bool isFirst = memory.samples == 0;
+  if (isFirst)
+  {
+    resetGauge(memory.freeHeap);
+    resetGauge(memory.maxFreeBlock);
+    resetGauge(memory.fragmentation);
+  }
+  memory.samples++;
+
+  // The allocator keeps the free total as it goes; the largest block and fragmentation need a
+  // walk of the whole heap, which is too slow for every pass and is done at most once per interval
+  if (!isFirst && now - memory.lastWalk < HEAP_WALK_INTERVAL_MS)
+  {
+    memory.freeHeap.update(ESP.getFreeHeap());
+    return;
+  }
+  uint32_t freeHeap;
+  uint32_t maxFreeBlock;
+  uint8_t fragmentation;
+  ESP.getHeapStats(&freeHeap, &maxFreeBlock, &fragmentation);
+  memory.lastWalk = now;
+  memory.freeHeap.update(freeHeap);
+  memory.maxFreeBlock.update(maxFreeBlock);
+  memory.fragmentation.update(fragmentation);
+}
+
+const PhaseMemory &phaseMemory(Phase phase)
+{
+  return phases[static_cast<uint8_t>(phase)];
+}
+
+PhaseScope::~PhaseScope()
+{
+  sampleMemory(phase);
+}
+
+void recordIdle(unsigned long ms)
+{
+  idleMillis += ms;
+}
+
+static void printLine(Print &out, const char *format, ...)
+{
+  char line[128];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  out.print(line);
+}
+
+static void printHeader(Print &out, const char *name, const char *type, const char *help)
+{
+  printLine(out, "# HELP %s %s\n", name, help);
+  printLine(out, "# TYPE %s %s\n", name, type);
+}
+
+static void printGauge(Print &out, const char *name, const char *help, Gauge PhaseMemory::*member)
+{
+  printHeader(out, name, "gauge", help);
+  for (uint8_t i = 0; i < PHASE_COUNT; i++)
+  {
+    const PhaseMemory &memory = phases[i];
+    if (memory.samples == 0)
+    {
+      continue;
+    }
+    const Gauge &gauge = memory.*member;
+    printLine(out, "%s{phase=\"%s\",stat=\"current\"} %lu\n", name, PHASE_NAMES[i], static_cast<unsigned long>(gauge.current));
+    printLine(out, "%s{phase=\"%s\",stat=\"min\"} %lu\n", name, PHASE_NAMES[i], static_cast<unsigned long>(gauge.min));
+    printLine(out, "%s{phase=\"%s\",stat=\"max\"} %lu\n", name, PHASE_NAMES[i], static_cast<unsigned long>(gauge.max));
+  }
+}
+
+static void printHistogram(Print &out, const char *name, const LatencyHistogram &histogram)
+{
+  // Prometheus buckets are cumulative
+  unsigned long cumulative = 0;
+  for (uint8_t i = 0; i < LatencyHistogram::BUCKET_COUNT; i++)
+  {
+    cumulative += histogram.bucket(i);
+    printLine(out, "%s_bucket{phase=\"%s\",le=\"%s\"} %lu\n", name, histogram.phase(), LatencyHistogram::BUCKET_LABELS[i], cumulative);
+  }
+  const unsigned long count = histogram.count();
+  const uint64_t sum = histogram.sumMicros();
+  printLine(out, "%s_bucket{phase=\"%s\",le=\"+Inf\"} %lu\n", name, histogram.phase(), count);
+  printLine(out, "%s_sum{phase=\"%s\"} %lu.%06lu\n", name, histogram.phase(),
+            static_cast<unsigned long>(sum / 1000000), static_cast<unsigned long>(sum % 1000000));
+  printLine(out, "%s_count{phase=\"%s\"} %lu\n", name, histogram.phase(), count);
+}
+
+void printMetrics(Print &out)
+{
+  printGauge(out, "nightpanorama_heap_free_bytes", "Free heap sampled at the end of each phase.",
+             &PhaseMemory::freeHeap);
+  printGauge(out, "nightpanorama_heap_max_free_block_bytes",
+             "Largest free heap block at the end of a phase, at most once a second per phase.",
+             &PhaseMemory::maxFreeBlock);
+  printGauge(out, "nightpanorama_heap_fragmentation_percent",
+             "Heap fragmentation at the end of a phase, at most once a second per phase.", &PhaseMemory::fragmentation);
+
+  printHeader(out, "nightpanorama_phase_memory_samples_total", "counter", "Heap samples taken per phase.");
+  for (uint8_t i = 0; i < PHASE_COUNT; i++)
+  {
+    printLine(out, "nightpanorama_phase_memory_samples_total{phase=\"%s\"} %lu\n", PHASE_NAMES[i],
+              static_cast<unsigned long>(phases[i].samples));
+  }
+
+  printHeader(out, "nightpanorama_phase_duration_seconds", "histogram", "Duration of each timed phase.");
+  for (const LatencyHistogram *histogram = LatencyHistogram::first(); histogram != nullptr; histogram = histogram->next())
+  {
+    printHistogram(out, "nightpanorama_phase_duration_seconds", *histogram);
+  }
+
+  printHeader(out, "nightpanorama_stack_free_min_bytes", "gauge",
+              "Smallest free space of the loop stack since boot, over all phases; not attributed to one.");
+  printLine(out, "nightpanorama_stack_free_min_bytes %lu\n", static_cast<unsigned long>(ESP.getFreeContStack()));
+  printHeader(out, "nightpanorama_heap_free_now_bytes", "gauge", "Free heap at the time of the scrape.");
+  printLine(out, "nightpanorama_heap_free_now_bytes %lu\n", static_cast<unsigned long>(ESP.getFreeHeap()));
+  printHeader(out, "nightpanorama_uptime_seconds", "counter", "Time since boot.");
+  printLine(out, "nightpanorama_uptime_seconds %lu\n", millis() / 1000);
+  printHeader(out, "nightpanorama_idle_seconds_total", "counter",
+              "Time loop() spent idle in delay() between events, whether or not the SDK slept.");
+  printLine(out, "nightpanorama_idle_seconds_total %lu.%03lu\n", static_cast<unsigned long>(idleMillis / 1000),
+            static_cast<unsigned long>(idleMillis % 1000));
+}
+
+void printMemorySummary(Print &out)
+{
+  uint32_t freeHeap;
+  uint32_t maxFreeBlock;
+  uint8_t fragmentation;
+  ESP.getHeapStats(&freeHeap, &maxFreeBlock, &fragmentation);
+
+  // The tightest the heap has been in any phase, including right now
+  uint32_t minFreeHeap = freeHeap;
+  uint32_t minMaxFreeBlock = maxFreeBlock;
+  uint32_t maxFragmentation = fragmentation;
+  for (const PhaseMemory &memory : phases)
+  {
+    if (memory.samples == 0)
+    {
+      continue;
+    }
+    minFreeHeap = min(minFreeHeap, memory.freeHeap.min);
+    minMaxFreeBlock = min(minMaxFreeBlock, memory.maxFreeBlock.min);
+    maxFragmentation = max(maxFragmentation, memory.fragmentation.max);
+  }
+
+  printLine(out, "Heap: %lu free (min %lu), block %lu (min %lu), frag %u%% (max %lu%%) | Loop stack min free: %lu\n",
+            static_cast<unsigned long>(freeHeap), static_cast<unsigned long>(minFreeHeap),
+            static_cast<unsigned long>(maxFreeBlock), static_cast<unsigned long>(minMaxFreeBlock),
+            fragmentation, static_cast<unsigned long>(maxFragmentation),
+            static_cast<unsigned long>(ESP.getFreeContStack()));
+}
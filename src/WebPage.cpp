@@ -0,0 +1,55 @@
+#include "WebPage.h"
+
+const char PAGE_HEAD[] PROGMEM =
+    "<html><head><style>"
+    "body { font-family: Arial, sans-serif; background-color: #f0f0f0; text-align: center; padding: 50px; }"
+    "h2 { color: #333; margin-bottom: 20px; }"
+    "form { background: #fff; padding: 20px; border-radius: 8px; display: inline-block; text-align: left; width: 350px; }"
+    ".form-row { display: flex; margin-bottom: 10px; }"
+    ".form-row label { flex: 1; }"                                                                         // 1/3 of the space
+    ".form-row input[type='text'] { flex: 2; padding: 10px; border: 1px solid #ddd; border-radius: 4px; }" // 2/3 of the space
+    "input[type='submit'] { width: 100%; background-color: #007bff; color: white; padding: 10px 20px; border: none; border-radius: 4px; cursor: pointer; }"
+    "input[type='submit']:hover { background-color: #0056b3; }"
+    "</style>"
+    "<script type='text/javascript'>"
+    "function validateInput(event) {"
+    "  var lat = document.getElementById('lat').value;"
+    "  var lon = document.getElementById('lon').value;"
+    "  var left = document.getElementById('left').value;"
+    "  var right = document.getElementById('right').value;"
+    "  if ((lat && isNaN(parseFloat(lat))) || (lon && isNaN(parseFloat(lon))) ||"
+    "      (left && isNaN(parseFloat(left))) || (right && isNaN(parseFloat(right)))) {"
+    "    alert('Please enter valid float numbers');"
+    "    event.preventDefault();"
+    "  }"
+    "  var horizon = document.getElementById('horizon').value;"
+    "  if (!/^\\s*(\\d+-\\d+:\\d+\\s*(,\\s*|$))*$/.test(horizon)) {"
+    "    alert('Horizon: comma-separated from-to:altitude in degrees, e.g. 80-130:25');"
+    "    event.preventDefault();"
+    "  }"
+    "}"
+    "</script>"
+    "</head><body>"
+    "<h2>Night Panorama</h2><form action='/submit' method='post' onsubmit='validateInput(event)'>"
+    "<div class='form-row'><label for='lat'>Latitude:</label><input type='text' id='lat' name='lat' value='";
+
+const char PAGE_LONGITUDE[] PROGMEM =
+    "'></div>"
+    "<div class='form-row'><label for='lon'>Longitude:</label><input type='text' id='lon' name='lon' value='";
+
+const char PAGE_LEFT[] PROGMEM =
+    "'></div>"
+    "<div class='form-row'><label for='left'>Left Border:</label><input type='text' id='left' name='left' value='";
+
+const char PAGE_RIGHT[] PROGMEM =
+    "'></div>"
+    "<div class='form-row'><label for='right'>Right Border:</label><input type='text' id='right' name='right' value='";
+
+const char PAGE_HORIZON[] PROGMEM =
+    "'></div>"
+    "<div class='form-row'><label for='horizon'>Horizon:</label><input type='text' id='horizon' name='horizon' placeholder='80-130:25,300-20:10' value='";
+
+const char PAGE_TAIL[] PROGMEM =
+    "'></div>"
+    "<input type='submit'>"
+    "</form></body></html>";
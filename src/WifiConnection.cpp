@@ -0,0 +1,81 @@
+#include <ESP8266WiFi.h>
+#include "WifiConnection.h"
+
+WifiConnection::WifiConnection(const char *ssid, const char *password)
+    : ssid(ssid), password(password), state(WifiState::Idle), attemptStart(0), backoff(5000, 300000)
+{
+}
+
+void WifiConnection::begin()
+{
+  // Reconnecting is handled here; the SDK's own retries and flash writes are not wanted
+  WiFi.persistent(false);
+  WiFi.setAutoReconnect(false);
+  WiFi.mode(WIFI_STA);
+  startAttempt();
+}
+
+bool WifiConnection::update()
+{
+  wl_status_t status = WiFi.status();
+  switch (state)
+  {
+  case WifiState::Connecting:
+    if (status == WL_CONNECTED)
+    {
+      state = WifiState::Connected;
+      backoff.reset();
+      Serial.print("Connected, IP address: ");
+      Serial.println(WiFi.localIP());
+      return true;
+    }
+    if (status == WL_NO_SSID_AVAIL || status == WL_CONNECT_FAILED || status == WL_WRONG_PASSWORD)
+    {
+      failAttempt("rejected");
+    }
+    else if (millis() - attemptStart >= ATTEMPT_TIMEOUT_MS)
+    {
+      failAttempt("timed out");
+    }
+    break;
+
+  case WifiState::Connected:
+    if (status != WL_CONNECTED)
+    {
+      Serial.println("WiFi connection lost");
+      startAttempt();
+    }
+    break;
+
+  case WifiState::Waiting:
+    if (backoff.isDue(millis()))
+    {
+      startAttempt();
+    }
+    break;
+
+  default:
+    break;
+  }
+  return false;
+}
+
+void WifiConnection::startAttempt()
+{
+  Serial.println("Connecting to WiFi...");
+  WiFi.begin(ssid, password);
+  attemptStart = millis();
+  state = WifiState::Connecting;
+}
+
+void WifiConnection::failAttempt(const char *reason)
+{
+  WiFi.disconnect();
+  backoff.schedule(millis());
+  state = WifiState::Waiting;
+  Serial.print("WiFi attempt ");
+  Serial.print(reason);
+  Serial.print(", retrying in ");
+  Serial.print(backoff.currentWait() / 1000);
+  Serial.println(" s");
+}
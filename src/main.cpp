@@ -2,8 +2,21 @@
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
 #include <LedControl.h>
+#include "Backoff.h"
+#include "ChunkedResponse.h"
+#include "Latency.h"
+#include "LedFramebuffer.h"
+#include "PowerManager.h"
+#include "Sprites.h"
+#include "StargazingFetcher.h"
 #include "StargazingInfo.h"
+#include "StargazingJson.h"
+#include "StargazingStore.h"
+#include "Telemetry.h"
+#include "TimerWheel.h"
+#include "WifiConnection.h"
 #include "Utils.h"
+#include "WebPage.h"
 
 // Pin configuration for the D1 Mini and MAX7219
 #define DIN_PIN D7
@@ -20,39 +33,63 @@ GeoLocation location = {.latitude = 47.9827, .longitude = 7.713736};
 FieldOfView fov = {.leftBound = 0, .rightBound = 360};
 
 // Timekeeping and interval settings
-unsigned long lastDisplaySwitchTime = 0;
 const unsigned long displaySwitchInterval = 15000; // 15 seconds
-unsigned long lastFetchTime = 0;
 const unsigned long fetchInterval = 3600000; // 1 hour in milliseconds
+const time_t skyEventHorizon = 2 * SECS_PER_DAY; // Sky events further ahead wait for a later fetch
+Backoff fetchRetry(10000, fetchInterval);     // After a failed fetch: 10 s, 20 s, ... up to the regular interval
 long berlinUtcOffset = 3600;
+unsigned long maxLoopMicros = 0; // Worst loop() iteration since the last report
+LatencyHistogram handleClientLatency("handle_client");
+LatencyHistogram toggleDisplayLatency("toggle_display");
 
 // Global instances
-WiFiClient Wifi;
+WifiConnection wifi(ssid, password);
+PowerManager power(PowerMode::Light); // PowerMode::Awake keeps CPU and radio running flat out
+bool isServerStarted = false;
 ESP8266WebServer server(80);
 LedControl lc = LedControl(DIN_PIN, CLK_PIN, CS_PIN, NUM_DEVICES);
+LedFramebuffer framebuffer(lc);
+static_assert(NUM_DEVICES == LedFramebuffer::DEVICES, "framebuffer is sized for the MAX7219 chain");
+StargazingFetcher fetcher;
 StargazingInfo stargazingInfo;
+char apiResponse[STARGAZING_JSON_SIZE]; // stargazingInfo as served by /api/stargazing
+size_t apiResponseLength = 0;           // 0 until the first fetch completes
 bool showsPlanets = false;
 
 // Function prototypes
+void onDisplayDue(TimerTask &task);
+void onFetchDue(TimerTask &task);
+void onSunset(TimerTask &task);
+void onSunrise(TimerTask &task);
+void onBodyRise(TimerTask &task);
+void onBodySet(TimerTask &task);
+void scheduleSkyEvents();
 void fetchStargazingInfo();
+void printStargazingInfo();
 void handleSubmit();
 void handleRoot();
-void setFullPanel(int row, int col);
-void showSunandEarth();
-void showMercury();
-void showVenus();
-void showMoon();
-void showMars();
-void showJupiter();
-void showSaturn();
-void showUranus();
-void showNeptune();
+void handleApiStargazing();
+void handleMetrics();
 void showPlanets(CelestialInfo celestialInfo);
 void showStars();
 void showClouds();
 void showPanorama(StargazingInfo stargazingInfo);
 void toggleDisplay();
 
+// Everything loop() does at a given time rather than on every pass
+TimerWheel timers;
+TimerTask displayTask(onDisplayDue);
+TimerTask fetchTask(onFetchDue); // The hourly refresh, or the retry after a failed fetch
+TimerTask sunsetTask(onSunset);
+TimerTask sunriseTask(onSunrise);
+struct BodyEvents
+{
+  TimerTask rise;
+  TimerTask set;
+  BodyEvents() : rise(onBodyRise), set(onBodySet) {}
+};
+BodyEvents bodyEvents[MAX_CELESTIAL_BODIES]; // Tagged with the body's index
+
 void setup()
 {
   // Initialize serial communication
@@ -66,49 +103,194 @@ void setup()
     lc.clearDisplay(index);
   }
 
-  // Connect to the specified Wi-Fi network
-  WiFi.begin(ssid, password);
-  while (WiFi.status() != WL_CONNECTED)
+  // Show the last result right away, or the default panorama without one;
+  // the fresh fetch replaces it once Wi-Fi is up and the fetch completes
+  StargazingSnapshot snapshot;
+  if (beginStargazingStore() && loadStargazingSnapshot(snapshot))
+  {
+    location = snapshot.location;
+    fov = snapshot.fov;
+    setHorizonProfile(snapshot.horizon);
+    stargazingInfo = snapshot.info;
+    apiResponseLength = serializeStargazingInfo(stargazingInfo, apiResponse, sizeof(apiResponse));
+  }
+  toggleDisplay();
+  timers.schedule(displayTask, millis(), displaySwitchInterval);
+  for (uint8_t i = 0; i < MAX_CELESTIAL_BODIES; i++)
   {
-    delay(5000);
-    Serial.println("Connecting to WiFi...");
+    bodyEvents[i].rise.tag = i;
+    bodyEvents[i].set.tag = i;
   }
-  Serial.print("Connected, IP address: ");
-  Serial.println(WiFi.localIP());
 
-  // Configure web server routes
+  // Configure web server routes; the server starts once Wi-Fi is connected
   server.on("/", handleRoot);
   server.on("/submit", handleSubmit);
-  server.begin();
-  fetchStargazingInfo();
+  server.on("/api/stargazing", handleApiStargazing);
+  server.on("/metrics", handleMetrics);
+  const char *headerKeys[] = {"If-None-Match"}; // For the root page's conditional GET
+  server.collectHeaders(headerKeys, 1);
+
+  // Sleep settings go first, the listen interval is fixed on association;
+  // then associate in the background and let loop() pick up the connection
+  power.begin();
+  wifi.begin();
 }
 
 void loop()
 {
+  unsigned long loopStart = micros();
+
+  // Bring up the server and fetch as soon as the network is there
+  if (wifi.update())
+  {
+    if (!isServerStarted)
+    {
+      server.begin();
+      isServerStarted = true;
+    }
+    fetchStargazingInfo();
+  }
+
   // Handle incoming client requests
-  server.handleClient();
+  if (isServerStarted)
+  {
+    ScopedLatency timer(handleClientLatency);
+    server.handleClient();
+  }
+
+  // Display switches, refreshes and sky events; nothing runs unless one is due
+  timers.run(millis());
 
-  // Print location and field of view at regular intervals
-  if (millis() - lastDisplaySwitchTime >= displaySwitchInterval)
+  // Advance a running fetch by one bounded step; the old data stays on display until it completes
+  if (fetcher.isBusy())
   {
-    lastDisplaySwitchTime = millis();
-    String text = "Lat: " + String(location.latitude, 6) + " Lon: " + String(location.longitude, 6) + " | " + String(fov.leftBound) + " - " + String(fov.rightBound);
-    Serial.println(text);
-    toggleDisplay();
+    PhaseScope scope(Phase::Fetch);
+    if (fetcher.update())
+    {
+      stargazingInfo = fetcher.result();
+      apiResponseLength = serializeStargazingInfo(stargazingInfo, apiResponse, sizeof(apiResponse));
+      saveStargazingSnapshot({location, fov, getHorizonProfile(), stargazingInfo});
+      printStargazingInfo();
+      fetchRetry.reset();
+      scheduleSkyEvents();
+    }
+    else if (fetcher.getState() == FetchState::Failed)
+    {
+      fetchRetry.schedule(millis());
+      timers.schedule(fetchTask, millis(), fetchRetry.currentWait());
+    }
   }
-  if (millis() - lastFetchTime >= fetchInterval)
+
+  unsigned long loopMicros = micros() - loopStart;
+  if (loopMicros > maxLoopMicros)
+  {
+    maxLoopMicros = loopMicros;
+  }
+
+  // Sleep until the next display switch, refresh or sky event, a slice at a time; a fetch needs every pass
+  if (!fetcher.isBusy())
+  {
+    power.idle(timers.timeUntilNext(millis()));
+  }
+}
+
+// Print location and field of view at regular intervals and switch the display
+void onDisplayDue(TimerTask &task)
+{
+  String text = "Lat: " + String(location.latitude, 6) + " Lon: " + String(location.longitude, 6) + " | " + String(fov.leftBound) + " - " + String(fov.rightBound) + " | Max loop: " + String(maxLoopMicros) + " us | Idle: " + String(power.takeIdlePercent()) + "%";
+  Serial.println(text);
+  printMemorySummary(Serial);
+  maxLoopMicros = 0;
+  toggleDisplay();
+  timers.schedule(task, millis(), displaySwitchInterval);
+}
+
+void onFetchDue(TimerTask &task)
+{
+  // Without Wi-Fi the fetch starts on reconnect instead
+  if (wifi.isConnected() && !fetcher.isBusy())
   {
-    // Call fetchStargazingInfo and update lastFetchTime
-    lastFetchTime = millis();
     fetchStargazingInfo();
   }
+  else
+  {
+    timers.schedule(task, millis(), fetchInterval);
+  }
 }
 
-// Fetch StargazingInfo
+// The night begins: fetch the latest forecast for it
+void onSunset(TimerTask &task)
+{
+  Serial.println("Sunset");
+  if (wifi.isConnected() && !fetcher.isBusy())
+  {
+    fetchStargazingInfo();
+  }
+}
+
+// The night is over: its ephemeris results will not be asked for again
+void onSunrise(TimerTask &task)
+{
+  Serial.println("Sunrise");
+  clearCelestialCache();
+}
+
+// Show the planets as soon as one comes up or goes down, for a full display interval
+void onBodyRise(TimerTask &task)
+{
+  Serial.print(stargazingInfo.celestial.bodies[task.tag].name);
+  Serial.println(" rises");
+  showsPlanets = true;
+  toggleDisplay();
+  timers.schedule(displayTask, millis(), displaySwitchInterval);
+}
+
+void onBodySet(TimerTask &task)
+{
+  Serial.print(stargazingInfo.celestial.bodies[task.tag].name);
+  Serial.println(" sets");
+  showsPlanets = true;
+  toggleDisplay();
+  timers.schedule(displayTask, millis(), displaySwitchInterval);
+}
+
+// Registers the sunset, sunrise and body rise/set times of the current result
+// that lie within skyEventHorizon; events already past are dropped.
+void scheduleSkyEvents()
+{
+  const time_t now = fetcher.currentTime();
+  const unsigned long nowMillis = millis();
+  auto scheduleAt = [&](TimerTask &task, time_t when)
+  {
+    if (now != 0 && when > now && when - now <= skyEventHorizon)
+    {
+      timers.schedule(task, nowMillis, static_cast<unsigned long>(when - now) * 1000);
+    }
+    else
+    {
+      timers.cancel(task);
+    }
+  };
+
+  scheduleAt(sunsetTask, stargazingInfo.weather.nextSunset);
+  scheduleAt(sunriseTask, stargazingInfo.weather.nextSunrise);
+  for (uint8_t i = 0; i < MAX_CELESTIAL_BODIES; i++)
+  {
+    const bool isKnown = i < stargazingInfo.celestial.bodyCount;
+    scheduleAt(bodyEvents[i].rise, isKnown ? stargazingInfo.celestial.bodies[i].riseAndSet.riseTime : 0);
+    scheduleAt(bodyEvents[i].set, isKnown ? stargazingInfo.celestial.bodies[i].riseAndSet.setTime : 0);
+  }
+}
+
+// Start fetching StargazingInfo in the background; the next regular refresh is due an interval later
 void fetchStargazingInfo()
 {
-  stargazingInfo = getStargazingInfo(location, fov);
+  fetcher.begin(location, fov);
+  timers.schedule(fetchTask, millis(), fetchInterval);
+}
 
+void printStargazingInfo()
+{
   // Print weather info
   Serial.println("Weather Info:");
   Serial.print("Is Dew: ");
@@ -117,6 +299,12 @@ void fetchStargazingInfo()
   Serial.println(stargazingInfo.weather.rainAmount);
   Serial.print("Cloud Cover: ");
   Serial.println(stargazingInfo.weather.cloudCover);
+  Serial.print("Max Cloud Cover: ");
+  Serial.println(stargazingInfo.weather.maxCloudCover);
+  Serial.print("Clear Hours: ");
+  Serial.print(stargazingInfo.weather.clearHours);
+  Serial.print(" of ");
+  Serial.println(stargazingInfo.weather.nightHours);
   Serial.println("Next Sunset Time:");
   printHumanReadableTime(stargazingInfo.weather.nextSunset, berlinUtcOffset);
   Serial.println("Next Sunrise Time:");
@@ -139,6 +327,13 @@ void fetchStargazingInfo()
     Serial.print("Is Visible: ");
     Serial.println(stargazingInfo.celestial.bodies[i].isVisible ? "Yes" : "No");
   }
+
+  CelestialCacheStats cacheStats = getCelestialCacheStats();
+  Serial.print("Ephemeris cache: ");
+  Serial.print(cacheStats.hits);
+  Serial.print(" hits, ");
+  Serial.print(cacheStats.misses);
+  Serial.println(" misses");
 }
 
 void showWeather()
@@ -151,44 +346,65 @@ void showPlanets()
 
 void handleRoot()
 {
-  String page = "<html><head><style>";
-  page += "body { font-family: Arial, sans-serif; background-color: #f0f0f0; text-align: center; padding: 50px; }";
-  page += "h2 { color: #333; margin-bottom: 20px; }";
-  page += "form { background: #fff; padding: 20px; border-radius: 8px; display: inline-block; text-align: left; width: 350px; }";
-  page += ".form-row { display: flex; margin-bottom: 10px; }";
-  page += ".form-row label { flex: 1; }";                                                                         // 1/3 of the space
-  page += ".form-row input[type='text'] { flex: 2; padding: 10px; border: 1px solid #ddd; border-radius: 4px; }"; // 2/3 of the space
-  page += "input[type='submit'] { width: 100%; background-color: #007bff; color: white; padding: 10px 20px; border: none; border-radius: 4px; cursor: pointer; }";
-  page += "input[type='submit']:hover { background-color: #0056b3; }";
-  page += "</style>";
-  page += "<script type='text/javascript'>";
-  page += "function validateInput(event) {";
-  page += "  var lat = document.getElementById('lat').value;";
-  page += "  var lon = document.getElementById('lon').value;";
-  page += "  var left = document.getElementById('left').value;";
-  page += "  var right = document.getElementById('right').value;";
-  page += "  if ((lat && isNaN(parseFloat(lat))) || (lon && isNaN(parseFloat(lon))) ||";
-  page += "      (left && isNaN(parseFloat(left))) || (right && isNaN(parseFloat(right)))) {";
-  page += "    alert('Please enter valid float numbers');";
-  page += "    event.preventDefault();";
-  page += "  }";
-  page += "}";
-  page += "</script>";
-  page += "</head><body>";
-  page += "</head><body>";
-  page += "<h2>Night Panorama</h2><form action='/submit'>";
-  page += "<div class='form-row'><label for='lat'>Latitude:</label><input type='text' id='lat' name='lat' value='" + String(location.latitude, 6) + "'></div>";
-  page += "<div class='form-row'><label for='lon'>Longitude:</label><input type='text' id='lon' name='lon' value='" + String(location.longitude, 6) + "'></div>";
-  page += "<div class='form-row'><label for='left'>Left Border:</label><input type='text' id='left' name='left' value='" + String(fov.leftBound) + "'></div>";
-  page += "<div class='form-row'><label for='right'>Right Border:</label><input type='text' id='right' name='right' value='" + String(fov.rightBound) + "'></div>";
-  page += "<input type='submit'>";
-  page += "<form action='/submit' method='post' onsubmit='validateInput(event)'>";
-  page += "</form></body></html>";
-  server.send(200, "text/html", page);
+  PhaseScope scope(Phase::Http);
+  power.noteActivity();
+
+  // Only these five values vary; the rest of the page is streamed straight from flash
+  char values[4][16];
+  snprintf(values[0], sizeof(values[0]), "%.6f", location.latitude);
+  snprintf(values[1], sizeof(values[1]), "%.6f", location.longitude);
+  snprintf(values[2], sizeof(values[2]), "%d", fov.leftBound);
+  snprintf(values[3], sizeof(values[3]), "%d", fov.rightBound);
+  char horizon[HORIZON_TEXT_SIZE];
+  formatHorizonProfile(horizon, sizeof(horizon), getHorizonProfile());
+
+  // The page only changes with the location, the field of view, the horizon or the markup itself
+  uint32_t hash = 2166136261u; // FNV-1a
+  for (const char *value : values)
+  {
+    for (const char *c = value; *c != '\0'; c++)
+    {
+      hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+    }
+    hash = (hash ^ '|') * 16777619u;
+  }
+  for (const char *c = horizon; *c != '\0'; c++)
+  {
+    hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+  }
+  char etag[16];
+  snprintf(etag, sizeof(etag), "\"%u-%08lx\"", PAGE_VERSION, static_cast<unsigned long>(hash));
+
+  server.sendHeader("ETag", etag);
+  server.sendHeader("Cache-Control", "no-cache"); // Cache, but revalidate so a new location shows up
+  if (server.header("If-None-Match") == etag)
+  {
+    server.send(304);
+    return;
+  }
+
+  // Unknown length makes the server use chunked transfer, one chunk per part
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/html", "");
+  server.sendContent_P(PAGE_HEAD);
+  server.sendContent(values[0]);
+  server.sendContent_P(PAGE_LONGITUDE);
+  server.sendContent(values[1]);
+  server.sendContent_P(PAGE_LEFT);
+  server.sendContent(values[2]);
+  server.sendContent_P(PAGE_RIGHT);
+  server.sendContent(values[3]);
+  server.sendContent_P(PAGE_HORIZON);
+  server.sendContent(horizon);
+  server.sendContent_P(PAGE_TAIL);
+  server.sendContent(""); // Terminating chunk
 }
 
 void handleSubmit()
 {
+  PhaseScope scope(Phase::Http);
+  power.noteActivity();
+
   if (server.hasArg("lat") && server.arg("lat") != "")
   {
     location.latitude = server.arg("lat").toFloat();
@@ -205,340 +421,69 @@ void handleSubmit()
   {
     fov.rightBound = server.arg("right").toInt();
   }
+  // An empty profile is a flat horizon; text that does not parse leaves the profile as it was
+  HorizonProfile horizon;
+  if (server.hasArg("horizon") && parseHorizonProfile(server.arg("horizon").c_str(), horizon))
+  {
+    setHorizonProfile(horizon);
+  }
 
   server.sendHeader("Location", "/");
   server.send(303);
   fetchStargazingInfo();
 }
 
-void setFullPanel(int row, int col)
+// Serves the JSON rendered when the data last changed; polling never re-serializes
+void handleApiStargazing()
 {
-  // Validate row and column values
-  if (row < 0 || row > 7 || col < 0 || col > 31)
+  PhaseScope scope(Phase::Http);
+  power.noteActivity();
+
+  if (apiResponseLength == 0)
   {
-    // Handle invalid inputs here (e.g., log an error or silently return)
+    server.send_P(503, PSTR("application/json"), PSTR("{\"error\":\"no data yet\"}"));
     return;
   }
-
-  // Calculate the address based on the column
-  int addr = col / 8;
-
-  // Calculate the column within the specific 8x8 matrix
-  int matrixCol = col % 8;
-
-  // Set the LED state using the setLed function
-  lc.setLed(addr, row, matrixCol, true);
+  // apiResponse is in RAM, so not send_P, whose reads assume flash
+  server.send(200, "application/json", apiResponse, apiResponseLength);
 }
 
-void showSunandEarth()
-{
-  // Sun
-  setFullPanel(0, 0);
-  setFullPanel(0, 1);
-
-  setFullPanel(1, 0);
-  setFullPanel(1, 1);
-  setFullPanel(1, 2);
-
-  setFullPanel(2, 0);
-  setFullPanel(2, 1);
-  setFullPanel(2, 2);
-
-  setFullPanel(3, 0);
-  setFullPanel(3, 1);
-  setFullPanel(3, 2);
-  setFullPanel(3, 3);
-
-  setFullPanel(4, 0);
-  setFullPanel(4, 1);
-  setFullPanel(4, 2);
-  setFullPanel(4, 3);
-
-  setFullPanel(5, 0);
-  setFullPanel(5, 1);
-  setFullPanel(5, 2);
-
-  setFullPanel(6, 0);
-  setFullPanel(6, 1);
-  setFullPanel(6, 2);
-
-  setFullPanel(7, 0);
-  setFullPanel(7, 1);
-
-  // Earth
-  setFullPanel(4, 11);
-  setFullPanel(5, 11);
-  setFullPanel(4, 12);
-  setFullPanel(5, 12);
-}
-void showMercury()
-{
-  setFullPanel(4, 5);
-  setFullPanel(5, 5);
-  setFullPanel(4, 6);
-  setFullPanel(5, 6);
-}
-void showVenus()
-{
-  setFullPanel(4, 8);
-  setFullPanel(5, 8);
-  setFullPanel(4, 9);
-  setFullPanel(5, 9);
-}
-void showMoon()
-{
-  setFullPanel(2, 12);
-}
-void showMars()
-{
-  setFullPanel(4, 14);
-  setFullPanel(5, 14);
-  setFullPanel(4, 15);
-  setFullPanel(5, 15);
-}
-void showJupiter()
-{
-  setFullPanel(4, 18);
-  setFullPanel(5, 18);
-  setFullPanel(6, 18);
-  setFullPanel(4, 19);
-  setFullPanel(5, 19);
-  setFullPanel(6, 19);
-  setFullPanel(4, 20);
-  setFullPanel(5, 20);
-  setFullPanel(6, 20);
-}
-void showSaturn()
-{
-  setFullPanel(4, 23);
-  setFullPanel(5, 23);
-  setFullPanel(4, 24);
-  setFullPanel(5, 24);
-}
-void showUranus()
+// Prometheus scrape target; streamed in chunks so the body is never held in RAM
+void handleMetrics()
 {
-  setFullPanel(4, 26);
-  setFullPanel(5, 26);
-  setFullPanel(4, 27);
-  setFullPanel(5, 27);
-}
-void showNeptune()
-{
-  setFullPanel(4, 29);
-  setFullPanel(5, 29);
-  setFullPanel(4, 30);
-  setFullPanel(5, 30);
+  PhaseScope scope(Phase::Http);
+  power.noteActivity();
+
+  ChunkedResponse response(server);
+  response.begin(200, "text/plain; version=0.0.4");
+  printMetrics(response);
+  response.end();
 }
 
 // Function to show planets based on their visibility
 void showPlanets(CelestialInfo celestialInfo)
 {
-  for (int index = 0; index < NUM_DEVICES; index++)
-  {
-    lc.clearDisplay(index);
-  }
-  showSunandEarth();
+  framebuffer.clear();
+  framebuffer.blit(SPRITE_SUN_AND_EARTH);
   for (int i = 0; i < celestialInfo.bodyCount; ++i)
   {
     if (celestialInfo.bodies[i].isVisible)
     {
-      CelestialObject it = stringToEnum(celestialInfo.bodies[i].name);
-      switch (it)
-      {
-      case Moon:
-        showMoon();
-        break;
-      case Mercury:
-        showMercury();
-        break;
-      case Venus:
-        showVenus();
-        break;
-      case Mars:
-        showMars();
-        break;
-      case Jupiter:
-        showJupiter();
-        break;
-      case Saturn:
-        showSaturn();
-        break;
-      case Uranus:
-        showUranus();
-        break;
-      case Neptune:
-        showNeptune();
-        break;
-      default:
-        break;
-      }
+      framebuffer.blit(planetSprite(celestialInfo.bodies[i].object));
     }
   }
 }
 
 void showStars()
 {
-  for (int index = 0; index < NUM_DEVICES; index++)
-  {
-    lc.clearDisplay(index);
-  }
-
-  setFullPanel(0, 2);
-  setFullPanel(0, 6);
-  setFullPanel(0, 9);
-  setFullPanel(0, 12);
-  setFullPanel(0, 17);
-  setFullPanel(0, 21);
-  setFullPanel(0, 23);
-  setFullPanel(0, 27);
-  setFullPanel(0, 30);
-
-  setFullPanel(1, 0);
-  setFullPanel(1, 5);
-  setFullPanel(1, 11);
-  setFullPanel(1, 14);
-  setFullPanel(1, 18);
-  setFullPanel(1, 22);
-  setFullPanel(1, 25);
-  setFullPanel(1, 31);
-
-  setFullPanel(2, 3);
-  setFullPanel(2, 7);
-  setFullPanel(2, 10);
-  setFullPanel(2, 13);
-  setFullPanel(2, 20);
-  setFullPanel(2, 28);
-
-  setFullPanel(4, 3);
-  setFullPanel(4, 4);
-  setFullPanel(4, 5);
-  setFullPanel(4, 9);
-  setFullPanel(4, 10);
-  setFullPanel(4, 11);
-
-  setFullPanel(4, 18);
-  setFullPanel(4, 19);
-  setFullPanel(4, 20);
-  setFullPanel(4, 28);
-  setFullPanel(4, 29);
-  setFullPanel(4, 30);
-
-  setFullPanel(5, 3);
-  setFullPanel(5, 4);
-  setFullPanel(5, 5);
-  setFullPanel(5, 9);
-  setFullPanel(5, 10);
-  setFullPanel(5, 11);
-
-  setFullPanel(5, 18);
-  setFullPanel(5, 19);
-  setFullPanel(5, 20);
-  setFullPanel(5, 28);
-  setFullPanel(5, 29);
-  setFullPanel(5, 30);
-
-  setFullPanel(6, 4);
-  setFullPanel(6, 10);
-  setFullPanel(6, 19);
-  setFullPanel(6, 29);
-
-  for (int index = 0; index < 32; index++)
-  {
-    setFullPanel(7, index);
-  }
+  framebuffer.clear();
+  framebuffer.blit(SPRITE_STARS);
 }
 
 void showClouds()
 {
-  for (int index = 0; index < NUM_DEVICES; index++)
-  {
-    lc.clearDisplay(index);
-  }
-
-  setFullPanel(0, 2);
-  setFullPanel(0, 3);
-  setFullPanel(0, 4);
-  setFullPanel(0, 9);
-  setFullPanel(0, 10);
-  setFullPanel(0, 11);
-  setFullPanel(0, 16);
-  setFullPanel(0, 17);
-  setFullPanel(0, 18);
-  setFullPanel(0, 23);
-  setFullPanel(0, 24);
-  setFullPanel(0, 25);
-
-  setFullPanel(1, 0);
-  setFullPanel(1, 1);
-  setFullPanel(1, 2);
-  setFullPanel(1, 3);
-  setFullPanel(1, 4);
-  setFullPanel(1, 8);
-  setFullPanel(1, 9);
-  setFullPanel(1, 10);
-  setFullPanel(1, 11);
-  setFullPanel(1, 12);
-  setFullPanel(1, 16);
-  setFullPanel(1, 17);
-  setFullPanel(1, 18);
-  setFullPanel(1, 19);
-  setFullPanel(1, 20);
-  setFullPanel(1, 24);
-  setFullPanel(1, 25);
-  setFullPanel(1, 26);
-  setFullPanel(1, 27);
-  setFullPanel(1, 28);
-
-  setFullPanel(2, 2);
-  setFullPanel(2, 3);
-  setFullPanel(2, 4);
-  setFullPanel(2, 9);
-  setFullPanel(2, 10);
-  setFullPanel(2, 11);
-  setFullPanel(2, 15);
-  setFullPanel(2, 16);
-  setFullPanel(2, 17);
-  setFullPanel(2, 22);
-  setFullPanel(2, 23);
-  setFullPanel(2, 24);
-
-  setFullPanel(4, 3);
-  setFullPanel(4, 4);
-  setFullPanel(4, 5);
-  setFullPanel(4, 9);
-  setFullPanel(4, 10);
-  setFullPanel(4, 11);
-
-  setFullPanel(4, 18);
-  setFullPanel(4, 19);
-  setFullPanel(4, 20);
-  setFullPanel(4, 28);
-  setFullPanel(4, 29);
-  setFullPanel(4, 30);
-
-  setFullPanel(5, 3);
-  setFullPanel(5, 4);
-  setFullPanel(5, 5);
-  setFullPanel(5, 9);
-  setFullPanel(5, 10);
-  setFullPanel(5, 11);
-
-  setFullPanel(5, 18);
-  setFullPanel(5, 19);
-  setFullPanel(5, 20);
-  setFullPanel(5, 28);
-  setFullPanel(5, 29);
-  setFullPanel(5, 30);
-
-  setFullPanel(6, 4);
-  setFullPanel(6, 10);
-  setFullPanel(6, 19);
-  setFullPanel(6, 29);
-
-  for (int index = 0; index < 32; index++)
-  {
-    setFullPanel(7, index);
-  }
+  framebuffer.clear();
+  framebuffer.blit(SPRITE_CLOUDS);
 }
 
 void showPanorama(WeatherInfo WeatherInfo)
@@ -555,6 +500,9 @@ void showPanorama(WeatherInfo WeatherInfo)
 
 void toggleDisplay()
 {
+  PhaseScope scope(Phase::Render);
+  ScopedLatency timer(toggleDisplayLatency);
+
   if (showsPlanets)
   {
     showPlanets(stargazingInfo.celestial);
@@ -563,5 +511,6 @@ void toggleDisplay()
   {
     showPanorama(stargazingInfo.weather);
   }
+  framebuffer.flush();
   showsPlanets = !showsPlanets;
 }
@@ -0,0 +1,61 @@
+// Global operator new/delete that keep a running total of the bytes handed out,
+// so benchmarks can report the peak heap use of a stage. Each block carries its
+// size in a header; the counters are atomic because bench-batch allocates from
+// several threads.
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include "Allocations.h"
+
+static std::atomic<size_t> current(0);
+static std::atomic<size_t> peak(0);
+
+// Keeps the user block aligned as malloc's would be
+static const size_t HEADER_SIZE = alignof(max_align_t);
+
+static void *allocate(size_t size)
+{
+    void *block = malloc(HEADER_SIZE + size);
+    if (block == nullptr)
+        throw std::bad_alloc();
+    *static_cast<size_t *>(block) = size;
+
+    size_t now = current.fetch_add(size) + size;
+    size_t high = peak.load();
+    while (now > high && !peak.compare_exchange_weak(high, now))
+    {
+    }
+    return static_cast<char *>(block) + HEADER_SIZE;
+}
+
+static void release(void *pointer)
+{
+    if (pointer == nullptr)
+        return;
+    void *block = static_cast<char *>(pointer) - HEADER_SIZE;
+    current.fetch_sub(*static_cast<size_t *>(block));
+    free(block);
+}
+
+size_t allocatedBytes()
+{
+    return current.load();
+}
+
+void resetAllocationPeak()
+{
+    peak.store(current.load());
+}
+
+size_t allocationPeak()
+{
+    return peak.load();
+}
+
+void *operator new(size_t size) { return allocate(size); }
+void *operator new[](size_t size) { return allocate(size); }
+void operator delete(void *pointer) noexcept { release(pointer); }
+void operator delete[](void *pointer) noexcept { release(pointer); }
+void operator delete(void *pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { release(pointer); }
@@ -0,0 +1,18 @@
+#ifndef NATIVE_ALLOCATIONS_H
+#define NATIVE_ALLOCATIONS_H
+
+#include <stddef.h>
+
+// Heap accounting for the native program, fed by the global operator new/delete
+// replacements in Allocations.cpp.
+
+// Bytes currently allocated through operator new.
+size_t allocatedBytes();
+
+// Starts a new measurement: the peak is reset to what is allocated now.
+void resetAllocationPeak();
+
+// Highest allocatedBytes() since the last resetAllocationPeak().
+size_t allocationPeak();
+
+#endif // NATIVE_ALLOCATIONS_H
@@ -0,0 +1,100 @@
+// Throughput of getStargazingInfoBatch for a grid of locations, at 1, 2, 4, ...
+// threads up to the hardware thread count, against a sequential loop over the
+// default engine. Sunset and sunrise are fixed, so only the celestial part is timed.
+
+#include <Arduino.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "Benchmarks.h"
+#include "StargazingBatch.h"
+
+static const time_t SUNSET = 1710525600; // 2024-03-15 18:00 UTC
+static const time_t SUNRISE = SUNSET + 12 * SECS_PER_HOUR;
+
+// Field by field, as memcmp would also compare the padding of the structs
+static bool isSameCelestial(const CelestialInfo &a, const CelestialInfo &b)
+{
+    if (a.bodyCount != b.bodyCount)
+        return false;
+    for (uint8_t i = 0; i < a.bodyCount; ++i)
+    {
+        const CelestialBodyInfo &x = a.bodies[i];
+        const CelestialBodyInfo &y = b.bodies[i];
+        if (strcmp(x.name, y.name) != 0 || x.riseAndSet.riseTime != y.riseAndSet.riseTime ||
+            x.riseAndSet.setTime != y.riseAndSet.setTime || x.positionCulmination.hc != y.positionCulmination.hc ||
+            x.positionCulmination.zn != y.positionCulmination.zn || x.isVisible != y.isVisible)
+            return false;
+    }
+    return true;
+}
+
+template <typename Run>
+static double locationsPerSecond(size_t count, Run run)
+{
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return count / elapsed.count();
+}
+
+int benchBatch(int argc, char **argv)
+{
+    size_t count = argc >= 3 ? static_cast<size_t>(atol(argv[2])) : 4096;
+    unsigned maxThreads = argc >= 4 ? static_cast<unsigned>(atoi(argv[3])) : std::thread::hardware_concurrency();
+    if (count == 0 || maxThreads == 0)
+    {
+        printf("usage: bench-batch [locations] [max-threads]\n");
+        return 2;
+    }
+
+    // Spread the sites over the inhabited latitudes and all longitudes
+    std::vector<GeoLocation> locations(count);
+    std::vector<FieldOfView> fovs(count);
+    std::vector<StargazingInfo> sequential(count), batch(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        locations[i].latitude = -55.0f + 125.0f * (i % 97) / 96.0f;
+        locations[i].longitude = -180.0f + 360.0f * (i * 7919 % count) / count;
+        fovs[i] = {static_cast<uint16_t>(i % 360), static_cast<uint16_t>((i + 180) % 360)};
+        sequential[i].weather.nextSunset = batch[i].weather.nextSunset = SUNSET;
+        sequential[i].weather.nextSunrise = batch[i].weather.nextSunrise = SUNRISE;
+    }
+
+    printf("celestial batch, %zu locations\n", count);
+    double baseline = locationsPerSecond(count, [&]() {
+        CelestialEngine engine;
+        for (size_t i = 0; i < count; ++i)
+        {
+            engine.begin(sequential[i].celestial, locations[i]);
+            for (uint8_t body = 0; body < MAX_CELESTIAL_BODIES; ++body)
+                engine.computeBody(sequential[i].celestial, body, SUNSET, SUNRISE, fovs[i]);
+        }
+    });
+    printf("  sequential   : %10.0f locations/s\n", baseline);
+
+    int status = 0;
+    for (unsigned step = 1;; step *= 2)
+    {
+        unsigned threads = std::min(step, maxThreads);
+        double rate = locationsPerSecond(count, [&]() {
+            getStargazingInfoBatch(locations.data(), fovs.data(), batch.data(), count, threads);
+        });
+        printf("  %2u thread(s) : %10.0f locations/s (%.2fx)\n", threads, rate, rate / baseline);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!isSameCelestial(sequential[i].celestial, batch[i].celestial))
+            {
+                printf("  MISMATCH at location %zu\n", i);
+                status = 1;
+                break;
+            }
+        }
+        if (threads == maxThreads)
+            break;
+    }
+    return status;
+}
@@ -0,0 +1,90 @@
+// Microbenchmark for decoding the 72 hourly Open-Meteo timestamps:
+// the previous sscanf + makeTime decoder, the fixed-width decoder, and the
+// stride path used by getWeatherInfo (decode once, check HH:MM per entry).
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include <chrono>
+#include <stdio.h>
+#include "Benchmarks.h"
+#include "Utils.h"
+
+static const size_t SAMPLE_COUNT = 72;
+static const long UTC_OFFSET = 3600;
+
+// The decoder as it was before the fixed-width parser, kept as the baseline.
+static time_t legacyIso8601ToTime(const char *iso8601, long utcOffsetSeconds)
+{
+    tmElements_t tm;
+    int year, month, day, hour, minute;
+    if (sscanf(iso8601, "%4d-%2d-%2dT%2d:%2d", &year, &month, &day, &hour, &minute) == 5)
+    {
+        tm.Year = year - 1970;
+        tm.Month = month;
+        tm.Day = day;
+        tm.Hour = hour;
+        tm.Minute = minute;
+        tm.Second = 0;
+        time_t time = makeTime(tm);
+        return time != 0 ? time - utcOffsetSeconds : -1;
+    }
+    return -1;
+}
+
+template <typename Decode>
+static double timePerEntry(const char stamps[][20], unsigned iterations, time_t &checksum, Decode decode)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned n = 0; n < iterations; ++n)
+        checksum += decode(stamps);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(iterations) * SAMPLE_COUNT);
+}
+
+int benchIso8601(int argc, char **argv)
+{
+    unsigned iterations = argc >= 3 ? static_cast<unsigned>(atoi(argv[2])) : 20000;
+
+    char stamps[SAMPLE_COUNT][20];
+    for (size_t i = 0; i < SAMPLE_COUNT; ++i)
+        snprintf(stamps[i], sizeof(stamps[i]), "2024-03-%02uT%02u:00", unsigned(15 + i / 24), unsigned(i % 24));
+
+    time_t legacySum = 0, fixedSum = 0, strideSum = 0;
+
+    double legacy = timePerEntry(stamps, iterations, legacySum, [](const char s[][20]) {
+        time_t sum = 0;
+        for (size_t i = 0; i < SAMPLE_COUNT; ++i)
+            sum += legacyIso8601ToTime(s[i], UTC_OFFSET);
+        return sum;
+    });
+    double fixed = timePerEntry(stamps, iterations, fixedSum, [](const char s[][20]) {
+        time_t sum = 0;
+        for (size_t i = 0; i < SAMPLE_COUNT; ++i)
+            sum += iso8601ToTime(s[i], UTC_OFFSET);
+        return sum;
+    });
+    double stride = timePerEntry(stamps, iterations, strideSum, [](const char s[][20]) {
+        time_t sum = 0;
+        time_t first = iso8601ToTime(s[0], UTC_OFFSET);
+        for (size_t i = 0; i < SAMPLE_COUNT; ++i)
+        {
+            time_t time = first + static_cast<time_t>(i) * SECS_PER_HOUR;
+            if (!iso8601MatchesClock(s[i], time + UTC_OFFSET))
+                time = iso8601ToTime(s[i], UTC_OFFSET);
+            sum += time;
+        }
+        return sum;
+    });
+
+    printf("iso8601 decode, %zu hourly entries x %u iterations\n", SAMPLE_COUNT, iterations);
+    printf("  sscanf + makeTime : %8.1f ns/entry\n", legacy);
+    printf("  fixed-width       : %8.1f ns/entry (%.1fx)\n", fixed, legacy / fixed);
+    printf("  stride + HH:MM    : %8.1f ns/entry (%.1fx)\n", stride, legacy / stride);
+
+    if (legacySum != fixedSum || legacySum != strideSum)
+    {
+        printf("  MISMATCH: decoders disagree\n");
+        return 1;
+    }
+    return 0;
+}
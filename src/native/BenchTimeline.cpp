@@ -0,0 +1,80 @@
+// Cost per step of a full-night timeline for all eight bodies: computeNightTimeline,
+// which shares the date, Sun and sidereal time of a step between the bodies,
+// against calling calculateAlmanacData once per body and step, which makes
+// SiderealPlanets redo that work for every body. Also reports how far apart the
+// two ephemerides are, in degrees of altitude and azimuth.
+
+#include <Arduino.h>
+#include <chrono>
+#include <stdio.h>
+#include "Benchmarks.h"
+#include "NightTimeline.h"
+
+static const time_t SUNSET = 1710525600; // 2024-03-15 18:00 UTC
+static const time_t SUNRISE = SUNSET + 12 * SECS_PER_HOUR;
+static const GeoLocation LOCATION = {47.9827f, 7.713736f};
+static const FieldOfView FOV = {90, 270};
+
+template <typename Run>
+static double nanosecondsPerStep(unsigned steps, unsigned nights, Run run)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned night = 0; night < nights; ++night)
+        run(night);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(nights) * steps);
+}
+
+int benchTimeline(int argc, char **argv)
+{
+    unsigned steps = argc >= 3 ? static_cast<unsigned>(atoi(argv[2])) : TIMELINE_MAX_STEPS;
+    unsigned nights = argc >= 4 ? static_cast<unsigned>(atoi(argv[3])) : 200;
+    if (steps < 2 || steps > TIMELINE_MAX_STEPS || nights == 0)
+    {
+        printf("usage: bench-timeline [steps 2..%u] [nights]\n", TIMELINE_MAX_STEPS);
+        return 2;
+    }
+
+    static NightTimeline timeline;
+    static AlmanacData repeated[TIMELINE_MAX_STEPS][MAX_CELESTIAL_BODIES];
+    CelestialEngine engine;
+    CelestialInfo info;
+    engine.begin(info, LOCATION);
+    const HorizonMask &mask = engine.horizonMask(FOV);
+
+    // Consecutive nights, so neither side can reuse a previous result
+    double shared = nanosecondsPerStep(steps, nights, [&](unsigned night) {
+        time_t offset = static_cast<time_t>(night) * SECS_PER_DAY;
+        computeNightTimeline(timeline, LOCATION, SUNSET + offset, SUNRISE + offset, mask, steps);
+    });
+    double perBody = nanosecondsPerStep(steps, nights, [&](unsigned night) {
+        time_t offset = static_cast<time_t>(night) * SECS_PER_DAY;
+        long stepSeconds = static_cast<long>((SUNRISE - SUNSET) / (steps - 1));
+        for (unsigned i = 0; i < steps; ++i)
+        {
+            time_t time = SUNSET + offset + static_cast<time_t>(i) * stepSeconds;
+            for (uint8_t body = 0; body < MAX_CELESTIAL_BODIES; ++body)
+                repeated[i][body] = calculateAlmanacData(engine, static_cast<CelestialObject>(body), time, time);
+        }
+    });
+
+    // Both loops ended on the same night
+    float maxAltitude = 0, maxAzimuth = 0;
+    for (unsigned i = 0; i < steps; ++i)
+    {
+        for (uint8_t body = 0; body < MAX_CELESTIAL_BODIES; ++body)
+        {
+            const TrackPoint &point = timeline.bodies[body].points[i];
+            float altitude = fabsf(point.altitude / 10.0f - repeated[i][body].hc);
+            float azimuth = fabsf(fmodf(point.azimuth / 10.0f - repeated[i][body].zn + 540.0f, 360.0f) - 180.0f);
+            maxAltitude = std::max(maxAltitude, altitude);
+            maxAzimuth = std::max(maxAzimuth, azimuth);
+        }
+    }
+
+    printf("night timeline, %u steps x 8 bodies x %u nights\n", steps, nights);
+    printf("  calculateAlmanacData per body : %9.0f ns/step\n", perBody);
+    printf("  computeNightTimeline          : %9.0f ns/step (%.2fx)\n", shared, perBody / shared);
+    printf("  max difference                : %.2f deg altitude, %.2f deg azimuth\n", maxAltitude, maxAzimuth);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Peak heap of parsing one Open-Meteo body, counted by the operator new/delete
+// replacements in Allocations.cpp: the path before the streaming parser, which
+// read the whole body into a String with getString() and deserialized it into
+// a 12 KB DynamicJsonDocument, against parseWeatherResponse reading the stream.
+//
+// ArduinoJson is not part of the host build. Its document is one block of the
+// full capacity, allocated before the body is read, so the baseline holds a
+// block of that size while the String is read; everything ArduinoJson builds
+// goes into that block.
+
+#include <Arduino.h>
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "Allocations.h"
+#include "Benchmarks.h"
+#include "BufferStream.h"
+#include "WeatherInfo.h"
+
+// Capacity of the DynamicJsonDocument the getString() path used
+static const size_t BASELINE_DOCUMENT_CAPACITY = 12288;
+
+template <typename Run>
+static size_t peakBytes(Run run)
+{
+    size_t base = allocatedBytes();
+    resetAllocationPeak();
+    run();
+    return allocationPeak() - base;
+}
+
+int benchWeatherHeap(int argc, char **argv)
+{
+    const char *path = argc >= 3 ? argv[2] : "bench/fixtures/freiburg_first_72h.json";
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        printf("usage: bench-weather-heap [fixture.json]\n");
+        return 2;
+    }
+    std::string body;
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        body.append(buffer, length);
+    fclose(file);
+
+    size_t payloadLength = 0;
+    size_t baseline = peakBytes([&]() {
+        std::unique_ptr<char[]> document(new char[BASELINE_DOCUMENT_CAPACITY]);
+        BufferStream stream(body);
+        String payload = stream.readString();
+        // Stands in for deserializeJson filling the document, and keeps the block from being optimized away
+        strncpy(document.get(), payload.c_str(), BASELINE_DOCUMENT_CAPACITY - 1);
+        document[BASELINE_DOCUMENT_CAPACITY - 1] = '\0';
+        payloadLength = strlen(document.get());
+    });
+
+    WeatherInfo info = {};
+    bool isValid = false;
+    size_t streaming = peakBytes([&]() {
+        BufferStream stream(body);
+        isValid = parseWeatherResponse(stream, info);
+    });
+
+    printf("weather parse heap, %s (%zu B body)\n", path, body.size());
+    printf("  getString + document : %6zu B peak (%zu B document, body String of %zu B)\n", baseline,
+           BASELINE_DOCUMENT_CAPACITY, payloadLength);
+    printf("  streaming parser     : %6zu B peak (%.1fx less)\n", streaming,
+           streaming > 0 ? double(baseline) / streaming : 0.0);
+    if (!isValid || payloadLength != body.size())
+    {
+        printf("  the body was not read or parsed in full\n");
+        return 1;
+    }
+    return 0;
+}
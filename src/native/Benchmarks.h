@@ -0,0 +1,15 @@
+#ifndef NATIVE_BENCHMARKS_H
+#define NATIVE_BENCHMARKS_H
+
+// Host-only benchmarks and test tools, selected by the first argument of the native program.
+
+int benchIso8601(int argc, char **argv);
+int benchBatch(int argc, char **argv);
+int benchTimeline(int argc, char **argv);
+int benchWeatherHeap(int argc, char **argv);
+int replay(int argc, char **argv);
+int serveForecast(int argc, char **argv);
+int deviceLoop(int argc, char **argv);
+int loadGenerator(int argc, char **argv);
+
+#endif // NATIVE_BENCHMARKS_H
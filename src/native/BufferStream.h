@@ -0,0 +1,34 @@
+#ifndef NATIVE_BUFFERSTREAM_H
+#define NATIVE_BUFFERSTREAM_H
+
+#include <Arduino.h>
+#include <algorithm>
+#include <string.h>
+#include <string>
+
+// Serves a body held in memory the way the HTTP client serves the socket.
+class BufferStream : public Stream
+{
+public:
+    BufferStream(const std::string &body) : body(body), position(0) {}
+
+    int available() override { return static_cast<int>(body.size() - position); }
+    int read() override { return position < body.size() ? static_cast<uint8_t>(body[position++]) : -1; }
+    int peek() override { return position < body.size() ? static_cast<uint8_t>(body[position]) : -1; }
+    size_t readBytes(char *buffer, size_t length) override
+    {
+        length = std::min(length, body.size() - position);
+        memcpy(buffer, body.data() + position, length);
+        position += length;
+        return length;
+    }
+    using Stream::readBytes;
+    size_t write(uint8_t) override { return 0; }
+    using Print::write;
+
+private:
+    const std::string &body;
+    size_t position;
+};
+
+#endif // NATIVE_BUFFERSTREAM_H
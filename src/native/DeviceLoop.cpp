@@ -0,0 +1,318 @@
+// The firmware's loop() on the host: one pass serves at most one HTTP request on
+// the configuration routes and advances the StargazingFetcher by one step, as
+// server.handleClient() and fetcher.update() do on the device. Pointed at
+// serve-forecast and driven by `load`, it measures end-to-end fetch latency,
+// request latency while a fetch is in flight, and the longest loop pass.
+//
+//   device [http-port] [api-host api-port] [--fetches n] [--interval ms] [--duration s] [--sleep]
+//
+// The routes mirror handleRoot and handleSubmit (ESP8266WebServer has no host
+// shim): GET / returns the page with the current values, /submit takes lat, lon,
+// left, right and horizon from the query or a form body, restarts the fetch and
+// answers 303. A new fetch starts --interval ms after the previous one ended, from
+// the same TimerWheel the firmware uses; between events the loop sleeps in poll().
+// The run stops after --fetches finished fetches or --duration seconds.
+//
+// --sleep waits as PowerManager does on the device instead: in uninterruptible
+// slices handed out by the same SleepPlanner, none within 250 ms of a request.
+// The report then gives the fraction of the run spent idle in them and the request
+// latency that costs; without it, the fraction spent waiting in poll(). The
+// radio's beacon interval is not modelled.
+
+#include <Arduino.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+#include "Benchmarks.h"
+#include "Latency.h"
+#include "NetTools.h"
+#include "SleepPlanner.h"
+#include "StargazingFetcher.h"
+#include "TimerWheel.h"
+#include "WeatherInfo.h"
+
+static const int REQUEST_TIMEOUT_MS = 1000;
+
+// Same names as the firmware's histograms, so the two reports read alike
+static LatencyHistogram handleClientLatency("handle_client");
+static LatencyHistogram loopLatency("loop");
+
+// PowerManager's slice and stay-awake times
+static SleepPlanner planner(100, 250);
+
+struct DeviceState
+{
+    GeoLocation location = {47.9827f, 7.713736f};
+    FieldOfView fov = {0, 360};
+    StargazingFetcher fetcher;
+    unsigned long fetchStart = 0; // micros() at fetcher.begin
+    unsigned restarted = 0;       // Fetches abandoned by a submit
+};
+
+// Decodes the value of name from a query string or form body into value; false when the field is absent.
+static bool formValue(const char *form, const char *name, char *value, size_t size)
+{
+    const size_t nameLength = strlen(name);
+    for (const char *field = form; field != nullptr && *field != '\0';)
+    {
+        const char *end = field + strcspn(field, "& \r\n");
+        if (strncmp(field, name, nameLength) == 0 && field[nameLength] == '=')
+        {
+            size_t length = 0;
+            for (const char *c = field + nameLength + 1; c < end && length + 1 < size; ++c)
+            {
+                if (*c == '%' && end - c > 2)
+                {
+                    const char hex[3] = {c[1], c[2], '\0'};
+                    value[length++] = static_cast<char>(strtol(hex, nullptr, 16));
+                    c += 2;
+                }
+                else
+                {
+                    value[length++] = *c == '+' ? ' ' : *c;
+                }
+            }
+            value[length] = '\0';
+            return true;
+        }
+        field = *end == '&' ? end + 1 : nullptr;
+    }
+    return false;
+}
+
+static void startFetch(DeviceState &device)
+{
+    if (device.fetcher.isBusy())
+        device.restarted++;
+    device.fetcher.begin(device.location, device.fov);
+    device.fetchStart = micros();
+}
+
+static DeviceState device;
+static TimerWheel timers;
+static TimerTask fetchTask([](TimerTask &) {
+    if (!device.fetcher.isBusy())
+        startFetch(device);
+});
+
+static void handleRoot(int fd, const DeviceState &device)
+{
+    char horizon[HORIZON_TEXT_SIZE];
+    formatHorizonProfile(horizon, sizeof(horizon), getHorizonProfile());
+    char body[1024];
+    int bodyLength = snprintf(body, sizeof(body),
+                              "<!DOCTYPE html><html><head><title>NightPanoramaC</title></head><body>"
+                              "<h1>Location</h1><form action=\"/submit\" method=\"post\">"
+                              "<label>Latitude <input name=\"lat\" value=\"%.6f\"></label><br>"
+                              "<label>Longitude <input name=\"lon\" value=\"%.6f\"></label><br>"
+                              "<label>Left bound <input name=\"left\" value=\"%d\"></label><br>"
+                              "<label>Right bound <input name=\"right\" value=\"%d\"></label><br>"
+                              "<label>Horizon <input name=\"horizon\" value=\"%s\"></label><br>"
+                              "<input type=\"submit\" value=\"Save\"></form></body></html>",
+                              device.location.latitude, device.location.longitude, device.fov.leftBound,
+                              device.fov.rightBound, horizon);
+    char header[128];
+    int headerLength = snprintf(header, sizeof(header),
+                                "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %d\r\n"
+                                "Connection: close\r\n\r\n",
+                                bodyLength);
+    sendAll(fd, header, static_cast<size_t>(headerLength));
+    sendAll(fd, body, static_cast<size_t>(bodyLength));
+}
+
+static void handleSubmit(int fd, const char *request, DeviceState &device)
+{
+    // Query string of a GET, or the form body of a POST
+    const char *query = strchr(request, '?');
+    const char *lineEnd = strstr(request, "\r\n");
+    const char *form = query != nullptr && query < lineEnd ? query + 1 : strstr(request, "\r\n\r\n");
+    if (form != nullptr && form[0] == '\r')
+        form += 4;
+
+    // As on the device, empty fields keep their value, except the horizon, where empty means flat
+    char value[HORIZON_TEXT_SIZE];
+    if (formValue(form, "lat", value, sizeof(value)) && value[0] != '\0')
+        device.location.latitude = static_cast<float>(atof(value));
+    if (formValue(form, "lon", value, sizeof(value)) && value[0] != '\0')
+        device.location.longitude = static_cast<float>(atof(value));
+    if (formValue(form, "left", value, sizeof(value)) && value[0] != '\0')
+        device.fov.leftBound = static_cast<uint16_t>(atoi(value));
+    if (formValue(form, "right", value, sizeof(value)) && value[0] != '\0')
+        device.fov.rightBound = static_cast<uint16_t>(atoi(value));
+    HorizonProfile horizon;
+    if (formValue(form, "horizon", value, sizeof(value)) && parseHorizonProfile(value, horizon))
+        setHorizonProfile(horizon);
+
+    static const char RESPONSE[] = "HTTP/1.1 303 See Other\r\nLocation: /\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    sendAll(fd, RESPONSE, sizeof(RESPONSE) - 1);
+    startFetch(device);
+}
+
+// Accepts and answers one pending connection; false when none was waiting.
+static bool handleClient(int listener, DeviceState &device, std::vector<double> &requestMillis)
+{
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0)
+        return false;
+
+    ScopedLatency timer(handleClientLatency);
+    const unsigned long start = micros();
+    char request[2048];
+    if (readRequest(fd, request, sizeof(request), REQUEST_TIMEOUT_MS) >= 0)
+    {
+        if (strncmp(request, "GET / ", 6) == 0)
+        {
+            handleRoot(fd, device);
+        }
+        else if (strncmp(request, "GET /submit", 11) == 0 || strncmp(request, "POST /submit", 12) == 0)
+        {
+            handleSubmit(fd, request, device);
+        }
+        else
+        {
+            static const char NOT_FOUND[] = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            sendAll(fd, NOT_FOUND, sizeof(NOT_FOUND) - 1);
+        }
+    }
+    shutdown(fd, SHUT_WR);
+    close(fd);
+    requestMillis.push_back((micros() - start) / 1000.0);
+    return true;
+}
+
+int deviceLoop(int argc, char **argv)
+{
+    unsigned fetches = 5;
+    unsigned long intervalMs = 500;
+    unsigned long durationMs = 60000;
+    bool isSleeping = false;
+    std::vector<const char *> positional;
+    for (int i = 2; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--fetches") == 0 && hasValue)
+            fetches = static_cast<unsigned>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--interval") == 0 && hasValue)
+            intervalMs = static_cast<unsigned long>(atol(argv[++i]));
+        else if (strcmp(argv[i], "--duration") == 0 && hasValue)
+            durationMs = static_cast<unsigned long>(atol(argv[++i])) * 1000;
+        else if (strcmp(argv[i], "--sleep") == 0)
+            isSleeping = true;
+        else
+            positional.push_back(argv[i]);
+    }
+    if (positional.size() == 2 || positional.size() > 3 || fetches == 0)
+    {
+        printf("usage: device [http-port] [api-host api-port] [--fetches n] [--interval ms] [--duration s] "
+               "[--sleep]\n");
+        return 2;
+    }
+    const uint16_t httpPort = positional.size() >= 1 ? static_cast<uint16_t>(atoi(positional[0])) : 8080;
+    const char *apiHost = positional.size() == 3 ? positional[1] : "127.0.0.1";
+    const uint16_t apiPort = positional.size() == 3 ? static_cast<uint16_t>(atoi(positional[2])) : 8081;
+
+    int listener = listenTcp(httpPort, true);
+    if (listener < 0)
+    {
+        printf("cannot listen on port %u\n", httpPort);
+        return 1;
+    }
+    setWeatherApiEndpoint(apiHost, apiPort);
+    printf("device on port %u, forecasts from %s:%u, %u fetches\n", httpPort, apiHost, apiPort, fetches);
+    fflush(stdout);
+
+    std::vector<double> fetchMillis;
+    std::vector<double> requestMillis;
+    std::vector<double> requestDuringFetchMillis;
+    unsigned succeeded = 0, failed = 0;
+    unsigned long maxLoopMicros = 0;
+    unsigned long passes = 0;
+    unsigned long waitedMs = 0; // In poll(), or idle in sleep slices with --sleep
+    const unsigned long runStart = millis();
+
+    startFetch(device);
+    while (succeeded + failed < fetches && millis() - runStart < durationMs)
+    {
+        const unsigned long loopStart = micros();
+        bool isIdle;
+        {
+            ScopedLatency timer(loopLatency);
+            timers.run(millis());
+            const bool wasFetching = device.fetcher.isBusy();
+            const size_t served = requestMillis.size();
+            isIdle = !handleClient(listener, device, requestMillis);
+            if (!isIdle)
+                planner.noteActivity(millis());
+            if (wasFetching && requestMillis.size() > served)
+                requestDuringFetchMillis.push_back(requestMillis.back());
+
+            if (device.fetcher.isBusy())
+            {
+                isIdle = false;
+                const bool isComplete = device.fetcher.update();
+                if (isComplete || device.fetcher.getState() == FetchState::Failed)
+                {
+                    fetchMillis.push_back((micros() - device.fetchStart) / 1000.0);
+                    isComplete ? succeeded++ : failed++;
+                    timers.schedule(fetchTask, millis(), intervalMs);
+                }
+            }
+        }
+        unsigned long loopMicros = micros() - loopStart;
+        if (loopMicros > maxLoopMicros)
+            maxLoopMicros = loopMicros;
+        passes++;
+
+        // Nothing to do until a client connects or a timer is due, so wait for whichever comes first
+        if (isIdle)
+        {
+            const unsigned long waitStart = millis();
+            const unsigned long wait = timers.timeUntilNext(waitStart);
+            if (isSleeping)
+            {
+                const unsigned long slice = planner.plan(waitStart, wait);
+                if (slice > 0)
+                {
+                    sleepMs(static_cast<unsigned>(slice));
+                    planner.recordIdle(millis() - waitStart);
+                }
+            }
+            else
+            {
+                pollfd entry = {listener, POLLIN, 0};
+                poll(&entry, 1, static_cast<int>(wait < 1000 ? wait : 1000));
+            }
+            waitedMs += millis() - waitStart;
+        }
+    }
+    close(listener);
+
+    const unsigned long runMs = millis() - runStart;
+    printf("%u fetches ok, %u failed, %u restarted by a submit; %lu loop passes in %.1f s\n", succeeded, failed,
+           device.restarted, passes, runMs / 1000.0);
+    printf("%s %.1f%% of the run\n", isSleeping ? "idle in sleep slices" : "waiting in poll()",
+           runMs > 0 ? 100.0 * waitedMs / runMs : 0.0);
+    if (succeeded > 0)
+    {
+        const WeatherInfo &weather = device.fetcher.result().weather;
+        printf("last result: cloud %u%%, clear %u of %u hours, %u bodies\n", weather.cloudCover, weather.clearHours,
+               weather.nightHours, device.fetcher.result().celestial.bodyCount);
+    }
+    printLatencies("fetch end-to-end", fetchMillis);
+    printLatencies("request", requestMillis);
+    printLatencies("request during fetch", requestDuringFetchMillis);
+    printf("  longest loop pass %.2f ms\n", maxLoopMicros / 1000.0);
+
+    printf("phase histograms (count, mean us):\n");
+    for (const LatencyHistogram *histogram = LatencyHistogram::first(); histogram != nullptr; histogram = histogram->next())
+    {
+        if (histogram->count() > 0)
+            printf("  %-22s %8u %10.1f\n", histogram->phase(), histogram->count(),
+                   static_cast<double>(histogram->sumMicros()) / histogram->count());
+    }
+    return 0;
+}
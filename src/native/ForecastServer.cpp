@@ -0,0 +1,168 @@
+// Stand-in for the Open-Meteo /v1/forecast endpoint, so the fetch path can be
+// exercised against slow, fragmented, cut-off and failing responses without the
+// real API. Every request is answered with the same recorded body from
+// bench/fixtures, whatever its query, as HTTP/1.0 with Connection: close.
+//
+//   serve-forecast [port] [--fixture name] [--dir d] [--latency ms] [--chunk bytes]
+//                  [--chunk-delay ms] [--truncate bytes] [--status code] [--count n]
+//
+// --latency delays the status line, --chunk/--chunk-delay trickle the body out in
+// pieces, --truncate closes the connection after that many body bytes (the header
+// still announces the full length) and --status replaces 200. --count exits after
+// that many requests. Point the library at it with setWeatherApiEndpoint, or run
+// `device 8080 127.0.0.1 <port>`.
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Benchmarks.h"
+#include "NetTools.h"
+
+struct ForecastServerOptions
+{
+    std::string body;
+    unsigned latencyMs = 0;
+    size_t chunkBytes = 0; // 0 sends the body in one piece
+    unsigned chunkDelayMs = 0;
+    long truncateBytes = -1; // -1 sends the whole body
+    int status = 200;
+};
+
+static const char *reasonPhrase(int status)
+{
+    switch (status)
+    {
+    case 200:
+        return "OK";
+    case 400:
+        return "Bad Request";
+    case 404:
+        return "Not Found";
+    case 429:
+        return "Too Many Requests";
+    case 500:
+        return "Internal Server Error";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "Status";
+    }
+}
+
+static void answerRequest(int fd, const ForecastServerOptions &options, unsigned number)
+{
+    char request[1024];
+    if (readRequest(fd, request, sizeof(request), 5000) < 0)
+    {
+        printf("#%u: no complete request\n", number);
+        close(fd);
+        return;
+    }
+    const char *lineEnd = strstr(request, "\r\n");
+    printf("#%u: %.*s\n", number, lineEnd != nullptr ? static_cast<int>(lineEnd - request) : 0, request);
+    fflush(stdout);
+
+    if (options.latencyMs > 0)
+        sleepMs(options.latencyMs);
+
+    char header[160];
+    int headerLength = snprintf(header, sizeof(header),
+                                "HTTP/1.0 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n"
+                                "Connection: close\r\n\r\n",
+                                options.status, reasonPhrase(options.status), options.body.size());
+    bool isSent = sendAll(fd, header, static_cast<size_t>(headerLength));
+
+    size_t bodyLength = options.body.size();
+    if (options.truncateBytes >= 0 && static_cast<size_t>(options.truncateBytes) < bodyLength)
+        bodyLength = static_cast<size_t>(options.truncateBytes);
+    const size_t chunk = options.chunkBytes > 0 ? options.chunkBytes : bodyLength;
+    for (size_t sent = 0; isSent && sent < bodyLength; sent += chunk)
+    {
+        if (sent > 0 && options.chunkDelayMs > 0)
+            sleepMs(options.chunkDelayMs);
+        isSent = sendAll(fd, options.body.data() + sent, std::min(chunk, bodyLength - sent));
+    }
+    shutdown(fd, SHUT_WR);
+    close(fd);
+}
+
+int serveForecast(int argc, char **argv)
+{
+    uint16_t port = 8081;
+    std::string directory = "bench/fixtures";
+    std::string fixture = "freiburg_evening";
+    unsigned count = 0;
+    ForecastServerOptions options;
+    for (int i = 2; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--fixture") == 0 && hasValue)
+            fixture = argv[++i];
+        else if (strcmp(argv[i], "--dir") == 0 && hasValue)
+            directory = argv[++i];
+        else if (strcmp(argv[i], "--latency") == 0 && hasValue)
+            options.latencyMs = static_cast<unsigned>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--chunk") == 0 && hasValue)
+            options.chunkBytes = static_cast<size_t>(atol(argv[++i]));
+        else if (strcmp(argv[i], "--chunk-delay") == 0 && hasValue)
+            options.chunkDelayMs = static_cast<unsigned>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--truncate") == 0 && hasValue)
+            options.truncateBytes = atol(argv[++i]);
+        else if (strcmp(argv[i], "--status") == 0 && hasValue)
+            options.status = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--count") == 0 && hasValue)
+            count = static_cast<unsigned>(atoi(argv[++i]));
+        else if (argv[i][0] >= '0' && argv[i][0] <= '9')
+            port = static_cast<uint16_t>(atoi(argv[i]));
+        else
+        {
+            printf("usage: serve-forecast [port] [--fixture name] [--dir d] [--latency ms] [--chunk bytes]\n"
+                   "                      [--chunk-delay ms] [--truncate bytes] [--status code] [--count n]\n");
+            return 2;
+        }
+    }
+
+    std::string path = directory + "/" + fixture + ".json";
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        printf("cannot read %s\n", path.c_str());
+        return 2;
+    }
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        options.body.append(buffer, length);
+    fclose(file);
+
+    int listener = listenTcp(port, false);
+    if (listener < 0)
+    {
+        printf("cannot listen on port %u\n", port);
+        return 1;
+    }
+    printf("serving %s (%zu bytes) on port %u\n", path.c_str(), options.body.size(), port);
+    fflush(stdout);
+
+    // One thread per connection, so a slow response does not hold up the next request
+    for (unsigned number = 1; count == 0 || number <= count; ++number)
+    {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        if (count != 0 && number == count)
+        {
+            answerRequest(fd, options, number);
+            break;
+        }
+        std::thread(answerRequest, fd, std::cref(options), number).detach();
+    }
+    fflush(stdout);
+    close(listener);
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Load generator for the device's configuration routes. Each client thread opens
+// one connection per request, the way a browser without keep-alive would, and
+// alternates GET / with a POST /submit every --submit-every requests (0 never
+// submits). Works against `device` on the host or a real board on the LAN.
+//
+//   load host port [clients] [requests-per-client] [--submit-every n] [--think ms]
+//
+// Reports the latency distribution of both routes and the number of failed
+// requests (refused or reset connections, timeouts, unexpected status codes).
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "Benchmarks.h"
+#include "NetTools.h"
+
+static const int RESPONSE_TIMEOUT_MS = 5000;
+
+struct LoadResults
+{
+    std::mutex lock;
+    std::vector<double> rootMillis;
+    std::vector<double> submitMillis;
+    std::atomic<unsigned> errors{0};
+};
+
+// One request on a fresh connection; the latency in milliseconds, or -1 on failure.
+static double timeRequest(const char *host, uint16_t port, const char *request, int expectedStatus)
+{
+    auto start = std::chrono::steady_clock::now();
+    int fd = connectTcp(host, port);
+    if (fd < 0)
+        return -1;
+    size_t bodyBytes = 0;
+    int status = sendAll(fd, request, strlen(request)) ? readResponse(fd, RESPONSE_TIMEOUT_MS, bodyBytes) : -1;
+    close(fd);
+    if (status != expectedStatus)
+        return -1;
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int loadGenerator(int argc, char **argv)
+{
+    unsigned submitEvery = 10;
+    unsigned thinkMs = 0;
+    std::vector<const char *> positional;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--submit-every") == 0 && i + 1 < argc)
+            submitEvery = static_cast<unsigned>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--think") == 0 && i + 1 < argc)
+            thinkMs = static_cast<unsigned>(atoi(argv[++i]));
+        else
+            positional.push_back(argv[i]);
+    }
+    const unsigned clients = positional.size() >= 3 ? static_cast<unsigned>(atoi(positional[2])) : 4;
+    const unsigned requests = positional.size() >= 4 ? static_cast<unsigned>(atoi(positional[3])) : 100;
+    if (positional.size() < 2 || positional.size() > 4 || clients == 0 || requests == 0)
+    {
+        printf("usage: load host port [clients] [requests-per-client] [--submit-every n] [--think ms]\n");
+        return 2;
+    }
+    const char *host = positional[0];
+    const uint16_t port = static_cast<uint16_t>(atoi(positional[1]));
+
+    char rootRequest[160];
+    snprintf(rootRequest, sizeof(rootRequest), "GET / HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", host);
+    // Submits the default location again, so the values on the page stay put
+    static const char FORM[] = "lat=47.982700&lon=7.713736&left=0&right=360";
+    char submitRequest[256];
+    snprintf(submitRequest, sizeof(submitRequest),
+             "POST /submit HTTP/1.1\r\nHost: %s\r\nContent-Type: application/x-www-form-urlencoded\r\n"
+             "Content-Length: %zu\r\nConnection: close\r\n\r\n%s",
+             host, sizeof(FORM) - 1, FORM);
+
+    printf("load on %s:%u: %u clients x %u requests, submit every %u\n", host, port, clients, requests, submitEvery);
+    LoadResults results;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned c = 0; c < clients; ++c)
+    {
+        threads.emplace_back([&, c]() {
+            std::vector<double> rootMillis, submitMillis;
+            for (unsigned n = 1; n <= requests; ++n)
+            {
+                // Offset per client so the submits do not all arrive together
+                const bool isSubmit = submitEvery != 0 && (n + c) % submitEvery == 0;
+                double millis = isSubmit ? timeRequest(host, port, submitRequest, 303)
+                                         : timeRequest(host, port, rootRequest, 200);
+                if (millis < 0)
+                    results.errors++;
+                else
+                    (isSubmit ? submitMillis : rootMillis).push_back(millis);
+                if (thinkMs > 0)
+                    sleepMs(thinkMs);
+            }
+            std::lock_guard<std::mutex> guard(results.lock);
+            results.rootMillis.insert(results.rootMillis.end(), rootMillis.begin(), rootMillis.end());
+            results.submitMillis.insert(results.submitMillis.end(), submitMillis.begin(), submitMillis.end());
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const size_t completed = results.rootMillis.size() + results.submitMillis.size();
+    printf("%zu requests in %.2f s (%.0f/s), %u errors\n", completed, seconds, completed / seconds,
+           results.errors.load());
+    printLatencies("GET /", results.rootMillis);
+    printLatencies("POST /submit", results.submitMillis);
+    return results.errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "NetTools.h"
+
+int listenTcp(uint16_t port, bool isNonBlocking)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(fd, 64) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    if (isNonBlocking)
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+int connectTcp(const char *host, uint16_t port)
+{
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *results = nullptr;
+    if (getaddrinfo(host, service, &hints, &results) != 0)
+        return -1;
+
+    int fd = -1;
+    for (addrinfo *ai = results; ai != nullptr && fd < 0; ai = ai->ai_next)
+    {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(results);
+    return fd;
+}
+
+bool sendAll(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Waits for data; false on timeout or error.
+static bool waitReadable(int fd, int timeoutMs)
+{
+    pollfd entry = {fd, POLLIN, 0};
+    int ready;
+    do
+        ready = poll(&entry, 1, timeoutMs);
+    while (ready < 0 && errno == EINTR);
+    return ready > 0;
+}
+
+int readRequest(int fd, char *buffer, size_t size, int timeoutMs)
+{
+    size_t length = 0;
+    size_t expected = 0; // Headers plus body, once the headers are complete
+    while (expected == 0 || length < expected)
+    {
+        if (length + 1 >= size || !waitReadable(fd, timeoutMs))
+            return -1;
+        ssize_t n = recv(fd, buffer + length, size - 1 - length, 0);
+        if (n <= 0)
+            return -1;
+        length += static_cast<size_t>(n);
+        buffer[length] = '\0';
+
+        const char *end = strstr(buffer, "\r\n\r\n");
+        if (expected == 0 && end != nullptr)
+        {
+            expected = static_cast<size_t>(end - buffer) + 4;
+            const char *contentLength = strcasestr(buffer, "\r\nContent-Length:");
+            if (contentLength != nullptr && contentLength < end)
+                expected += static_cast<size_t>(atol(contentLength + 17));
+        }
+    }
+    return static_cast<int>(length);
+}
+
+int readResponse(int fd, int timeoutMs, size_t &bodyBytes)
+{
+    char buffer[1024];
+    char statusLine[16] = {};
+    size_t total = 0;
+    size_t headerEnd = 0;
+    uint32_t window = 0; // Last four bytes, to find the end of the headers across reads
+    for (;;)
+    {
+        if (!waitReadable(fd, timeoutMs))
+            return -1;
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0)
+            return -1;
+        if (n == 0)
+            break;
+        for (ssize_t i = 0; i < n && headerEnd == 0; ++i)
+        {
+            if (total + i < sizeof(statusLine) - 1)
+                statusLine[total + i] = buffer[i];
+            window = (window << 8) | static_cast<uint8_t>(buffer[i]);
+            if (window == 0x0D0A0D0A)
+                headerEnd = total + i + 1;
+        }
+        total += static_cast<size_t>(n);
+    }
+    int status;
+    if (sscanf(statusLine, "HTTP/%*d.%*d %d", &status) != 1)
+        return -1;
+    bodyBytes = headerEnd > 0 ? total - headerEnd : 0;
+    return status;
+}
+
+void sleepMs(unsigned ms)
+{
+    timespec delay = {static_cast<time_t>(ms / 1000), static_cast<long>(ms % 1000) * 1000000L};
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR)
+    {
+    }
+}
+
+void printLatencies(const char *label, std::vector<double> &samples)
+{
+    if (samples.empty())
+    {
+        printf("  %-22s      none\n", label);
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double quantile) { return samples[static_cast<size_t>(quantile * (samples.size() - 1))]; };
+    printf("  %-22s %6zu  p50 %8.2f  p90 %8.2f  p99 %8.2f  max %8.2f ms\n", label, samples.size(), at(0.5), at(0.9),
+           at(0.99), samples.back());
+}
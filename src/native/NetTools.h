@@ -0,0 +1,31 @@
+#ifndef NATIVE_NETTOOLS_H
+#define NATIVE_NETTOOLS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Blocking HTTP/1.x plumbing over POSIX sockets, shared by serve-forecast,
+// device and load. Every exchange is one request per connection.
+
+// Listening socket on all interfaces, or -1.
+int listenTcp(uint16_t port, bool isNonBlocking);
+
+// Connected socket, or -1.
+int connectTcp(const char *host, uint16_t port);
+
+bool sendAll(int fd, const char *data, size_t length);
+
+// Reads one request (headers and any Content-Length body) into buffer, NUL-terminated.
+// Returns its length, or -1 on timeout, error or a request that does not fit.
+int readRequest(int fd, char *buffer, size_t size, int timeoutMs);
+
+// Reads a response until the server closes; returns the status code, or -1.
+int readResponse(int fd, int timeoutMs, size_t &bodyBytes);
+
+void sleepMs(unsigned ms);
+
+// Prints "label: n, p50, p90, p99, max" for durations in milliseconds; sorts samples.
+void printLatencies(const char *label, std::vector<double> &samples);
+
+#endif // NATIVE_NETTOOLS_H
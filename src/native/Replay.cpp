@@ -0,0 +1,407 @@
+// Replays the recorded Open-Meteo bodies in bench/fixtures through the weather and
+// celestial pipeline, without a network: parseWeatherResponse (the parsing path of
+// getWeatherInfo), CelestialEngine::compute (behind getCelestialInfo) and
+// computeNightTimeline. The horizon stage repeats the celestial one under a horizon
+// that hides everything; the ephemeris stage checks that the timeline's own ephemeris
+// stays within EPHEMERIS_TOLERANCE of SiderealPlanets at every step of the night. For every fixture it reports the mean time and the peak
+// heap use of each stage and checks the results against golden.txt, so a change
+// that alters an output or slows a stage down shows up as a failed run or a number.
+//
+// The celestial golden lines pin what SiderealPlanets computes for every body, so
+// they must be recorded with the library the firmware links. On top of them, every
+// run asserts properties that hold whatever the ephemeris (see checkCelestial); a
+// failed assertion counts as a mismatch even where no golden line is recorded.
+//
+// Golden lines are "<fixture> <stage> <result>". Stages without a golden line are
+// reported but do not fail; `--record` rewrites golden.txt from the current results.
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "Allocations.h"
+#include "Benchmarks.h"
+#include "BufferStream.h"
+#include "NightTimeline.h"
+#include "Utils.h"
+#include "WeatherInfo.h"
+
+static const GeoLocation DEFAULT_LOCATION = {47.9827f, 7.713736f};
+static const FieldOfView FOV = {90, 270};
+static const HorizonProfile RAISED_HORIZON = {{{0, 359, HORIZON_MAX_ALTITUDE}}, 1}; // Nothing can be seen
+static const double EPHEMERIS_TOLERANCE = 0.5; // Degrees on the sky between the timeline and SiderealPlanets
+
+struct StageResult
+{
+    double microseconds; // Mean per run
+    size_t peakBytes;    // Heap in use at the peak of one run, above what was in use before it
+    std::string output;  // Compared with the golden line; filled in by the caller
+};
+
+template <typename Run>
+static StageResult measure(unsigned iterations, Run run)
+{
+    StageResult result;
+    size_t base = allocatedBytes();
+    resetAllocationPeak();
+    run();
+    result.peakBytes = allocationPeak() - base;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned n = 0; n < iterations; ++n)
+        run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    result.microseconds = std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+    return result;
+}
+
+static bool readFile(const std::string &path, std::string &contents)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+    char buffer[4096];
+    size_t length;
+    contents.clear();
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents.append(buffer, length);
+    fclose(file);
+    return true;
+}
+
+static std::vector<std::string> listFixtures(const std::string &directory)
+{
+    std::vector<std::string> names;
+    if (DIR *dir = opendir(directory.c_str()))
+    {
+        while (dirent *entry = readdir(dir))
+        {
+            std::string name = entry->d_name;
+            if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0)
+                names.push_back(name.substr(0, name.size() - 5));
+        }
+        closedir(dir);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// The location is echoed in the body; the parser has no use for it, so it is picked out here.
+static GeoLocation fixtureLocation(const std::string &body)
+{
+    GeoLocation location = DEFAULT_LOCATION;
+    size_t latitude = body.find("\"latitude\":");
+    size_t longitude = body.find("\"longitude\":");
+    if (latitude != std::string::npos && longitude != std::string::npos)
+    {
+        location.latitude = strtof(body.c_str() + latitude + 11, nullptr);
+        location.longitude = strtof(body.c_str() + longitude + 12, nullptr);
+    }
+    return location;
+}
+
+static std::string describeWeather(bool isValid, const WeatherInfo &info)
+{
+    if (!isValid)
+        return "rejected";
+    char line[160];
+    snprintf(line, sizeof(line), "dew=%d rain=%u cloud=%u max=%u clear=%u/%u sunset=%lld sunrise=%lld",
+             info.isDew != 0, info.rainAmount, info.cloudCover, info.maxCloudCover, info.clearHours,
+             info.nightHours, static_cast<long long>(info.nextSunset), static_cast<long long>(info.nextSunrise));
+    return line;
+}
+
+// Visible intervals as minutes after sunset, which do not move with last-digit floating point changes.
+static std::string describeTimeline(const NightTimeline &timeline)
+{
+    std::string text;
+    char item[48];
+    for (const BodyTrack &track : timeline.bodies)
+    {
+        for (uint8_t i = 0; i < track.intervalCount; ++i)
+        {
+            snprintf(item, sizeof(item), "%s%s:%ld-%ld", text.empty() ? "" : " ", celestialObjectName(track.object),
+                     static_cast<long>((track.intervals[i].start - timeline.start) / 60),
+                     static_cast<long>((track.intervals[i].end - timeline.start) / 60));
+            text += item;
+        }
+    }
+    return text.empty() ? "none" : text;
+}
+
+static bool isSameBody(const CelestialBodyInfo &a, const CelestialBodyInfo &b)
+{
+    return a.object == b.object && strcmp(a.name, b.name) == 0 && a.riseAndSet.riseTime == b.riseAndSet.riseTime &&
+           a.riseAndSet.setTime == b.riseAndSet.setTime && a.positionCulmination.hc == b.positionCulmination.hc &&
+           a.positionCulmination.zn == b.positionCulmination.zn && a.isVisible == b.isVisible;
+}
+
+// Rise and set as minutes from sunset ("-" for never), culmination altitude and azimuth to
+// a tenth of a degree and the visibility flag of each body, which is what the golden pins.
+static std::string describeCelestial(const CelestialInfo &info, time_t sunset)
+{
+    std::string text;
+    char item[64];
+    auto minutes = [&](time_t time) {
+        return time == 0 ? std::string("-") : std::to_string(static_cast<long>((time - sunset) / 60));
+    };
+    for (uint8_t i = 0; i < info.bodyCount; ++i)
+    {
+        const CelestialBodyInfo &body = info.bodies[i];
+        snprintf(item, sizeof(item), "%s%s:%s/%s/%.1f/%.1f%s", text.empty() ? "" : " ", body.name,
+                 minutes(body.riseAndSet.riseTime).c_str(), minutes(body.riseAndSet.setTime).c_str(),
+                 body.positionCulmination.hc, body.positionCulmination.zn, body.isVisible ? "+" : "-");
+        text += item;
+    }
+    return text.empty() ? "none" : text;
+}
+
+// Properties that hold whatever ephemeris the library computes: each visibility flag agrees
+// with the night window and the horizon mask, each body either never rises or rises and sets
+// once on the day of sunset, in either order, and a cache hit returns what was computed.
+static std::string checkCelestial(const CelestialInfo &info, const CelestialInfo &cached, time_t sunset, time_t sunrise,
+                                  const HorizonMask &mask)
+{
+    std::string flags;
+    std::string riseAndSet;
+    for (uint8_t i = 0; i < info.bodyCount; ++i)
+    {
+        const CelestialBodyInfo &body = info.bodies[i];
+        const bool isExpected = isUpAtNight(body.riseAndSet, sunset, sunrise) && mask.isVisible(body.positionCulmination);
+        if (body.isVisible != isExpected)
+            flags += std::string(" ") + body.name + (body.isVisible ? "+" : "-");
+
+        const time_t rise = body.riseAndSet.riseTime;
+        const time_t set = body.riseAndSet.setTime;
+        const bool isNeverUp = rise == 0 && set == 0;
+        if (!isNeverUp && (rise == 0 || set == 0 || rise == set || llabs(static_cast<long long>(set - rise)) >= SECS_PER_DAY))
+            riseAndSet += std::string(" ") + body.name;
+    }
+    if (info.bodyCount != MAX_CELESTIAL_BODIES)
+        return "bodies=" + std::to_string(info.bodyCount);
+    bool isSameCached = cached.bodyCount == info.bodyCount;
+    for (uint8_t i = 0; isSameCached && i < info.bodyCount; ++i)
+        isSameCached = isSameBody(info.bodies[i], cached.bodies[i]);
+    if (flags.empty() && riseAndSet.empty() && isSameCached)
+        return "ok";
+    std::string text = flags.empty() ? "" : "flags" + flags + ";";
+    text += riseAndSet.empty() ? "" : "rise/set" + riseAndSet + ";";
+    return isSameCached ? text : text + "cache";
+}
+
+// Largest angle on the sky between a timeline point and calculateAlmanacData at the same time, over
+// all bodies and steps. Within the tolerance the golden line is the same for every fixture.
+static std::string compareEphemerides(CelestialEngine &engine, const NightTimeline &timeline, const GeoLocation &location)
+{
+    CelestialInfo info;
+    engine.begin(info, location);
+    double worst = 0;
+    const char *worstBody = "";
+    uint8_t worstStep = 0;
+    for (uint8_t step = 0; step < timeline.stepCount; ++step)
+    {
+        const time_t time = timeline.timeAt(step);
+        for (const BodyTrack &track : timeline.bodies)
+        {
+            const AlmanacData reference = calculateAlmanacData(engine, track.object, time, time);
+            const double altitude = radians(track.points[step].altitude / 10.0);
+            const double azimuth = radians(track.points[step].azimuth / 10.0);
+            const double cosAngle = sin(altitude) * sin(radians(reference.hc)) +
+                                    cos(altitude) * cos(radians(reference.hc)) * cos(azimuth - radians(reference.zn));
+            const double angle = degrees(acos(std::max(-1.0, std::min(1.0, cosAngle))));
+            if (angle > worst)
+            {
+                worst = angle;
+                worstBody = celestialObjectName(track.object);
+                worstStep = step;
+            }
+        }
+    }
+    char text[64];
+    if (worst <= EPHEMERIS_TOLERANCE)
+        snprintf(text, sizeof(text), "within %.1f deg", EPHEMERIS_TOLERANCE);
+    else
+        snprintf(text, sizeof(text), "%s off by %.1f deg at +%ld min", worstBody, worst,
+                 static_cast<long>((timeline.timeAt(worstStep) - timeline.start) / 60));
+    return text;
+}
+
+// Names of the bodies flagged visible; the horizon stage expects none.
+static std::string describeVisible(const CelestialInfo &info)
+{
+    std::string text;
+    for (uint8_t i = 0; i < info.bodyCount; ++i)
+    {
+        if (info.bodies[i].isVisible)
+            text += (text.empty() ? "" : " ") + std::string(info.bodies[i].name);
+    }
+    return text.empty() ? "none" : text;
+}
+
+int replay(int argc, char **argv)
+{
+    std::string directory = "bench/fixtures";
+    unsigned iterations = 200;
+    bool isRecording = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--record") == 0)
+            isRecording = true;
+        else if (argv[i][0] >= '0' && argv[i][0] <= '9')
+            iterations = static_cast<unsigned>(atoi(argv[i]));
+        else
+            directory = argv[i];
+    }
+    if (iterations == 0)
+    {
+        printf("usage: replay [fixture-dir] [iterations] [--record]\n");
+        return 2;
+    }
+
+    std::vector<std::string> fixtures = listFixtures(directory);
+    if (fixtures.empty())
+    {
+        printf("no fixtures in %s\n", directory.c_str());
+        return 2;
+    }
+
+    // "<fixture> <stage>" -> result
+    std::map<std::string, std::string> golden;
+    std::string goldenPath = directory + "/golden.txt";
+    std::string contents;
+    if (readFile(goldenPath, contents))
+    {
+        size_t start = 0;
+        while (start < contents.size())
+        {
+            size_t end = contents.find('\n', start);
+            std::string line = contents.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            start = end == std::string::npos ? contents.size() : end + 1;
+            size_t second = line.find(' ', line.find(' ') + 1);
+            if (!line.empty() && line[0] != '#' && second != std::string::npos)
+                golden[line.substr(0, second)] = line.substr(second + 1);
+        }
+    }
+
+    printf("replay of %zu fixtures from %s, %u runs per stage\n", fixtures.size(), directory.c_str(), iterations);
+    printf("  %-24s %-9s %10s %10s  %s\n", "fixture", "stage", "us/run", "peak B", "golden");
+
+    CelestialEngine engine;
+    static NightTimeline timeline;
+    std::vector<std::string> recorded;
+    unsigned mismatches = 0, unchecked = 0;
+    auto check = [&](const std::string &fixture, const char *stage, const StageResult &result) {
+        std::string key = fixture + " " + stage;
+        const char *verdict;
+        auto expected = golden.find(key);
+        if (expected == golden.end())
+        {
+            verdict = "none";
+            unchecked++;
+        }
+        else if (expected->second == result.output)
+        {
+            verdict = "ok";
+        }
+        else
+        {
+            verdict = "MISMATCH";
+            mismatches++;
+        }
+        printf("  %-24s %-9s %10.2f %10zu  %s\n", fixture.c_str(), stage, result.microseconds, result.peakBytes, verdict);
+        if (expected != golden.end() && expected->second != result.output)
+        {
+            printf("      expected: %s\n      actual:   %s\n", expected->second.c_str(), result.output.c_str());
+        }
+        recorded.push_back(key + " " + result.output);
+    };
+
+    for (const std::string &fixture : fixtures)
+    {
+        std::string body;
+        if (!readFile(directory + "/" + fixture + ".json", body))
+        {
+            printf("  %-24s unreadable\n", fixture.c_str());
+            mismatches++;
+            continue;
+        }
+
+        WeatherInfo weather = {};
+        bool isValid = false;
+        StageResult parsed = measure(iterations, [&]() {
+            BufferStream stream(body);
+            weather = {};
+            isValid = parseWeatherResponse(stream, weather);
+        });
+        parsed.output = describeWeather(isValid, weather);
+        check(fixture, "weather", parsed);
+        if (!isValid)
+            continue;
+
+        const GeoLocation location = fixtureLocation(body);
+        CelestialInfo info;
+        StageResult celestial = measure(iterations, [&]() {
+            engine.clearCache();
+            info = engine.compute(location, weather.nextSunset, weather.nextSunrise, FOV);
+        });
+        celestial.output = describeCelestial(info, weather.nextSunset);
+        check(fixture, "celestial", celestial);
+
+        // Asserted on every run, recorded golden or not; the second compute is served from the cache
+        const uint32_t hits = engine.getCacheStats().hits;
+        CelestialInfo cached = engine.compute(location, weather.nextSunset, weather.nextSunrise, FOV);
+        std::string invariants = engine.getCacheStats().hits == hits + 1
+                                     ? checkCelestial(info, cached, weather.nextSunset, weather.nextSunrise,
+                                                      engine.horizonMask(FOV))
+                                     : "cache miss";
+        if (invariants != "ok")
+        {
+            printf("      celestial assertion failed: %s\n", invariants.c_str());
+            mismatches++;
+        }
+
+        // Raised to the zenith all around, the horizon must hide every body, wherever the library puts it
+        engine.setHorizonProfile(RAISED_HORIZON);
+        StageResult hidden = measure(1, [&]() {
+            engine.clearCache();
+            info = engine.compute(location, weather.nextSunset, weather.nextSunrise, FOV);
+        });
+        engine.setHorizonProfile({});
+        hidden.output = describeVisible(info);
+        check(fixture, "horizon", hidden);
+
+        StageResult track = measure(iterations, [&]() {
+            computeNightTimeline(timeline, location, weather.nextSunset, weather.nextSunrise, engine.horizonMask(FOV));
+        });
+        track.output = describeTimeline(timeline);
+        check(fixture, "timeline", track);
+
+        std::string difference;
+        StageResult ephemeris = measure(1, [&]() { difference = compareEphemerides(engine, timeline, location); });
+        ephemeris.output = difference;
+        check(fixture, "ephemeris", ephemeris);
+    }
+
+    if (isRecording)
+    {
+        FILE *file = fopen(goldenPath.c_str(), "w");
+        if (file == nullptr)
+        {
+            printf("cannot write %s\n", goldenPath.c_str());
+            return 1;
+        }
+        fprintf(file, "# <fixture> <stage> <result>; written by `program replay --record`\n");
+        for (const std::string &line : recorded)
+            fprintf(file, "%s\n", line.c_str());
+        fclose(file);
+        printf("recorded %zu golden lines to %s\n", recorded.size(), goldenPath.c_str());
+        return 0;
+    }
+
+    printf("%u mismatch(es), %u stage(s) without a golden line\n", mismatches, unchecked);
+    return mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+// Host entry point for the `native` environment. Runs the same NightPanoramaC
+// pipeline as the firmware so it can be profiled with ordinary Linux tools:
+//
+//   pio run -e native && .pio/build/native/program [lat lon [left right]]
+//   .pio/build/native/program bench-iso8601 [iterations]
+//   .pio/build/native/program bench-batch [locations] [max-threads]
+//   .pio/build/native/program bench-timeline [steps] [nights]
+//   .pio/build/native/program bench-weather-heap [fixture.json]
+//   .pio/build/native/program simulate [seed [lat lon [left right]]]
+//   .pio/build/native/program replay [fixture-dir] [iterations] [--record]
+//   .pio/build/native/program serve-forecast [port] [--fixture name] [--latency ms] ...
+//   .pio/build/native/program device [http-port] [api-host api-port] [--sleep]
+//   .pio/build/native/program load host port [clients] [requests-per-client]
+//
+// serve-forecast, device and load together run the fetch and the configuration
+// routes end to end on one machine, against a local stand-in for Open-Meteo.
+//
+// `simulate` needs no network: it prints a reproducible synthetic sky for a fixed
+// sample night, with positions drawn from the engine's seeded generator.
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Benchmarks.h"
+#include "StargazingInfo.h"
+#include "Utils.h"
+
+// Night used by `simulate`
+static const time_t SAMPLE_SUNSET = 1710525600; // 2024-03-15 18:00 UTC
+static const time_t SAMPLE_SUNRISE = SAMPLE_SUNSET + 12 * SECS_PER_HOUR;
+
+static void printStargazingInfo(const StargazingInfo &stargazingInfo, long utcOffset)
+{
+    Serial.println("Weather Info:");
+    Serial.print("Is Dew: ");
+    Serial.println(stargazingInfo.weather.isDew ? "Yes" : "No");
+    Serial.print("Rain Amount: ");
+    Serial.println(stargazingInfo.weather.rainAmount);
+    Serial.print("Cloud Cover: ");
+    Serial.println(stargazingInfo.weather.cloudCover);
+    Serial.print("Max Cloud Cover: ");
+    Serial.println(stargazingInfo.weather.maxCloudCover);
+    Serial.print("Clear Hours: ");
+    Serial.print(stargazingInfo.weather.clearHours);
+    Serial.print(" of ");
+    Serial.println(stargazingInfo.weather.nightHours);
+    Serial.println("Next Sunset Time:");
+    printHumanReadableTime(stargazingInfo.weather.nextSunset, utcOffset);
+    Serial.println("Next Sunrise Time:");
+    printHumanReadableTime(stargazingInfo.weather.nextSunrise, utcOffset);
+
+    Serial.println("Celestial Info:");
+    for (int i = 0; i < stargazingInfo.celestial.bodyCount; ++i)
+    {
+        const CelestialBodyInfo &body = stargazingInfo.celestial.bodies[i];
+        Serial.print("Body Name: ");
+        Serial.println(body.name);
+        Serial.print("Rise Time: ");
+        printHumanReadableTime(body.riseAndSet.riseTime, utcOffset);
+        Serial.print("Set Time: ");
+        printHumanReadableTime(body.riseAndSet.setTime, utcOffset);
+        Serial.print("Altitude: ");
+        Serial.println(body.positionCulmination.hc);
+        Serial.print("Azimuth: ");
+        Serial.println(body.positionCulmination.zn);
+        Serial.print("Is Visible: ");
+        Serial.println(body.isVisible ? "Yes" : "No");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "bench-iso8601") == 0)
+        return benchIso8601(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "bench-batch") == 0)
+        return benchBatch(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "bench-timeline") == 0)
+        return benchTimeline(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "bench-weather-heap") == 0)
+        return benchWeatherHeap(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "replay") == 0)
+        return replay(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "serve-forecast") == 0)
+        return serveForecast(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "device") == 0)
+        return deviceLoop(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "load") == 0)
+        return loadGenerator(argc, argv);
+
+    const bool isSimulation = argc >= 2 && strcmp(argv[1], "simulate") == 0;
+    uint32_t seed = 1;
+    if (isSimulation)
+    {
+        if (argc >= 3)
+            seed = static_cast<uint32_t>(strtoul(argv[2], nullptr, 0));
+        if (seed == 0)
+            seed = 1; // 0 would switch simulation off
+        // Drop the mode and seed so the location arguments follow as usual
+        const int skip = argc >= 3 ? 2 : 1;
+        argc -= skip;
+        argv += skip;
+    }
+
+    GeoLocation location = {.latitude = 47.9827, .longitude = 7.713736};
+    FieldOfView fov = {.leftBound = 0, .rightBound = 360};
+    long utcOffset = 3600;
+
+    if (argc >= 3)
+    {
+        location.latitude = static_cast<float>(atof(argv[1]));
+        location.longitude = static_cast<float>(atof(argv[2]));
+    }
+    if (argc >= 5)
+    {
+        fov.leftBound = static_cast<uint16_t>(atoi(argv[3]));
+        fov.rightBound = static_cast<uint16_t>(atoi(argv[4]));
+    }
+
+    Serial.begin(115200);
+    StargazingInfo stargazingInfo;
+    if (isSimulation)
+    {
+        CelestialEngine engine;
+        engine.setSimulation(seed);
+        stargazingInfo.weather = {};
+        stargazingInfo.weather.nextSunset = SAMPLE_SUNSET;
+        stargazingInfo.weather.nextSunrise = SAMPLE_SUNRISE;
+        stargazingInfo.celestial = engine.compute(location, SAMPLE_SUNSET, SAMPLE_SUNRISE, fov);
+    }
+    else
+    {
+        stargazingInfo = getStargazingInfo(location, fov);
+    }
+    printStargazingInfo(stargazingInfo, utcOffset);
+    return 0;
+}